@@ -2,6 +2,7 @@
 
 #include <Common.hpp>
 #include <RenderDevice.hpp>
+#include <RenderThread.hpp>
 #include <Renderer.hpp>
 #include <Scene.hpp>
 #include <SceneManager.hpp>
@@ -14,6 +15,13 @@ public:
 	Application(String name, Path working_dir);
 	virtual ~Application();
 
+	// --headless: WindowSettings::Headless
+	// --null:     RenderAPI::None, no window and no GPU work, see RenderDeviceNull
+	// --threaded: frames are drawn on a RenderThread
+	// --no-shader-cache: shaders are compiled from source, see mShaderCache
+	// --no-spirv: shaders are compiled from GLSL, see mShaderModules
+	// --frames=N: exit after N frames, 0 runs until closed
+	void ParseArguments(int argc, char** argv);
 	void Run();  // Run the game loop
 	void Terminate();
 
@@ -59,6 +67,7 @@ private:
 	bool OnWindowClose();
 	bool OnWindowFocus(bool b);
 	bool OnFramebuffer(vec2ui resolution);
+	void UpdateViewport(vec2ui resolution);
 
 private:
 	String mName;
@@ -76,12 +85,29 @@ private:
 	const u32    mMaxFixedIterations {8};
 	double       mFixedDeltaTime {1.0 / 60.0};
 	double       mDeltaTime {0.0};
+	u32          mFrameLimit {0};
 
 protected:
-	RenderDevicePtr     mRenderDevice;
-	WindowPtr           mWindow;
-	UniquePtr<Renderer> mRenderer;
-	SceneManager        mSceneManager;
+	// set in the derived constructor, used when the window and the renderer are
+	// created in Run()
+	WindowSettings   mWindowSettings;
+	RendererSettings mRendererSettings;
+	// Initialize still runs with the context on the main thread, the render thread
+	// starts after it. Anything else that uses the device directly goes through
+	// RenderThread::Submit.
+	bool mUseRenderThread {false};
+	// Linked shader programs, relative to the working directory. Empty compiles
+	// every shader from source, see Shader::SetBinaryCache.
+	Path mShaderCache {"cache/shaders"};
+	// SPIR-V modules built by tools/, empty when the build has none. Empty compiles
+	// every shader from GLSL, see Shader::SetModuleDirectory.
+	Path mShaderModules {ENGINE_SPIRV_PATH};
+
+	RenderDevicePtr         mRenderDevice;
+	WindowPtr               mWindow;
+	UniquePtr<Renderer>     mRenderer;
+	UniquePtr<RenderThread> mRenderThread;
+	SceneManager            mSceneManager;
 };
 
 extern UniquePtr<Application> CreateApp();
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Common.hpp>
+#include <Framebuffer.hpp>
+#include <Transform.hpp>
+
+// A layer that rarely changes, e.g. a parallax background or a static UI panel.
+// It is rendered once into a framebuffer and drawn as a single quad every frame
+// until invalidated, see Renderer::BeginCachedLayer.
+class CachedLayer
+{
+public:
+	// Resolution of the framebuffer, usually the window's
+	CachedLayer(u8            layer,
+	            u32           width,
+	            u32           height,
+	            TextureFormat format = TextureFormat::RGBA8);
+	CachedLayer(const CachedLayer&)            = delete;
+	CachedLayer& operator=(const CachedLayer&) = delete;
+
+	// The content has to be rendered again before the next DrawCachedLayer
+	void Invalidate()
+	{
+		mValid = false;
+	}
+
+	bool IsValid() const
+	{
+		return mValid;
+	}
+
+	// Invalidates the layer
+	void Resize(u32 width, u32 height);
+
+	u8 GetLayer() const
+	{
+		return mLayer;
+	}
+
+	const FramebufferPtr& GetFramebuffer() const
+	{
+		return mFramebuffer;
+	}
+
+private:
+	friend class Renderer;
+
+	u8             mLayer;
+	bool           mValid;
+	FramebufferPtr mFramebuffer;
+	Transform      mViewProjection;  // the content was rendered with
+};
@@ -18,6 +18,9 @@ struct TagComponent
 	String Tag;
 };
 
+// Change it through Entity::PatchComponent after the first frame, or call
+// Entity::MarkMoved after editing it in place, culling only sees changes it is
+// told about.
 struct TransformComponent
 {
 	TransformComponent()                          = default;
@@ -31,16 +34,30 @@ struct TransformComponent
 struct SpriteRendererComponent
 {
 	SpriteRendererComponent() = default;
-	explicit SpriteRendererComponent(TexturePtr& texture)
-	        : Texture(texture)
+	explicit SpriteRendererComponent(const TexturePtr& texture)
+	        : Sprite(texture)
+	{
+	}
+	explicit SpriteRendererComponent(const SubTexture& sprite)
+	        : Sprite(sprite)
 	{
 	}
 	SpriteRendererComponent(const SpriteRendererComponent&) = default;
 
-	TexturePtr Texture;
+	SubTexture Sprite;
 	Color      Color {Color::WHITE};
 	bool       FlipX {false};
 	bool       FlipY {false};
+	u8         Layer {0};
+};
+
+// Marks a sprite that rarely changes, e.g. background and level geometry. It is
+// kept in a retained StaticBatch and only re-uploaded when its transform or
+// sprite component is patched.
+struct StaticComponent
+{
+	StaticComponent()                       = default;
+	StaticComponent(const StaticComponent&) = default;
 };
 
 struct CircleRendererComponent
@@ -51,6 +68,7 @@ struct CircleRendererComponent
 	Color Color {Color::WHITE};
 	float Thickness {1.0f};
 	float Smoothness {0.03f};
+	u8    Layer {0};
 };
 
 struct CameraComponent
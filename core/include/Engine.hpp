@@ -15,7 +15,11 @@
 #include <Scene.hpp>
 #include <Shader.hpp>
 #include <Signal.hpp>
+#include <SpatialGrid.hpp>
+#include <StaticBatch.hpp>
 #include <Texture.hpp>
+#include <TextureAtlas.hpp>
+#include <TextureSlots.hpp>
 #include <Timer.hpp>
 #include <Transform.hpp>
 #include <Vector2.hpp>
@@ -38,6 +38,8 @@ public:
 		return c;
 	}
 
+	// Edits through the reference are not seen by the culling grid, see
+	// PatchComponent and MarkMoved
 	template<typename T>
 	T& GetComponent()
 	{
@@ -52,6 +54,19 @@ public:
 		return mScene->GetEntities().get<T>(mHandle);
 	}
 
+	// Modifies the component in place and notifies the scene, e.g. moved
+	// transforms are re-inserted into the culling grid.
+	template<typename T, typename... Func>
+	T& PatchComponent(Func&&... func)
+	{
+		ASSERT(HasComponent<T>(), "Component does not exist");
+		return mScene->GetEntities().patch<T>(mHandle, std::forward<Func>(func)...);
+	}
+
+	// Re-inserts the entity into the culling grid before the next render, after
+	// its transform or renderer component was changed in place
+	void MarkMoved();
+
 	template<typename T>
 	void RemoveComponent()
 	{
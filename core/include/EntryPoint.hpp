@@ -6,6 +6,7 @@ int main(int argc, char** argv)
 	TRACE("Engine starting");
 
 	auto app = CreateApp();
+	app->ParseArguments(argc, argv);
 	app->Run();
 
 	TRACE("Engine exiting");
@@ -1,6 +1,37 @@
 #pragma once
 
+#include <Color.hpp>
+#include <Common.hpp>
+#include <Texture.hpp>
+#include <Vector2.hpp>
 
+using FramebufferPtr = SharedPtr<class Framebuffer>;
+
+// Offscreen render target, see RenderDevice::SetRenderTarget. The color
+// attachments are plain textures and can be drawn like any other, rows from
+// bottom to top.
 class Framebuffer
 {
-};
\ No newline at end of file
+public:
+	virtual ~Framebuffer() = default;
+
+	// One color attachment per format, fragment output i writes attachment i
+	static FramebufferPtr Create(u32                          width,
+	                             u32                          height,
+	                             const Vector<TextureFormat>& formats,
+	                             bool                         filter = false);
+
+	// Replaces the attachments, their content is lost
+	virtual void Resize(u32 width, u32 height) = 0;
+	// Clears all attachments, whether bound or not
+	virtual void Clear(Color color) = 0;
+
+	virtual vec2ui GetResolution() const = 0;
+	virtual u32    GetWidth() const      = 0;
+	virtual u32    GetHeight() const     = 0;
+
+	virtual u32               GetColorAttachmentCount() const     = 0;
+	virtual const TexturePtr& GetColorAttachment(u32 index) const = 0;
+
+	virtual u32 GetID() const = 0;
+};
@@ -1 +1,41 @@
 #pragma once
+
+#include <Framebuffer.hpp>
+
+class FramebufferGL final: public Framebuffer
+{
+public:
+	FramebufferGL(u32                          width,
+	              u32                          height,
+	              const Vector<TextureFormat>& formats,
+	              bool                         filter);
+	~FramebufferGL() override;
+
+	void Resize(u32 width, u32 height) override;
+	void Clear(Color color) override;
+
+	vec2ui GetResolution() const override;
+	u32    GetWidth() const override;
+	u32    GetHeight() const override;
+
+	u32               GetColorAttachmentCount() const override;
+	const TexturePtr& GetColorAttachment(u32 index) const override;
+
+	u32 GetID() const override;
+
+private:
+	void CreateAttachments();
+	void Attach() const;
+
+private:
+	// Created by the first GetID, in the context that renders to it, see
+	// RenderDeviceGL::ContainerType. The textures are shared and created at once.
+	mutable u32             mID {0};
+	mutable std::thread::id mOwner;
+	mutable bool            mAttached {false};
+	u32                     mWidth;
+	u32                     mHeight;
+	bool                    mFiltered;
+	Vector<TextureFormat>   mFormats;
+	Vector<TexturePtr>      mAttachments;
+};
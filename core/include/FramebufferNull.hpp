@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Framebuffer.hpp>
+
+class FramebufferNull final: public Framebuffer
+{
+public:
+	FramebufferNull(u32                          width,
+	                u32                          height,
+	                const Vector<TextureFormat>& formats,
+	                bool                         filter);
+
+	void Resize(u32 width, u32 height) override;
+	void Clear(Color color) override;
+
+	vec2ui GetResolution() const override;
+	u32    GetWidth() const override;
+	u32    GetHeight() const override;
+
+	u32               GetColorAttachmentCount() const override;
+	const TexturePtr& GetColorAttachment(u32 index) const override;
+
+	u32 GetID() const override;
+
+private:
+	void CreateAttachments();
+
+private:
+	u32                   mID;
+	u32                   mWidth;
+	u32                   mHeight;
+	bool                  mFiltered;
+	Vector<TextureFormat> mFormats;
+	Vector<TexturePtr>    mAttachments;
+};
@@ -6,6 +6,9 @@ using VertexBufferPtr = SharedPtr<class VertexBuffer>;
 using IndexBufferPtr  = SharedPtr<class IndexBuffer>;
 using VertexArrayPtr  = SharedPtr<class VertexArray>;
 
+using IndirectBufferPtr = SharedPtr<class IndirectBuffer>;
+using UniformBufferPtr  = SharedPtr<class UniformBuffer>;
+
 enum class VertexType
 {
 	Byte,
@@ -16,6 +19,14 @@ enum class VertexType
 	UByte2,
 	UByte3,
 	UByte4,
+	UShort,
+	UShort2,
+	UShort3,
+	UShort4,
+	Half,  // 16-bit float, read as float by shaders
+	Half2,
+	Half3,
+	Half4,
 	Float,
 	Float2,
 	Float3,
@@ -31,6 +42,27 @@ enum class VertexType
 	Bool,
 };
 
+enum class BufferUsage
+{
+	Dynamic,  // updated through SetData, the driver copies the data
+	Stream    // persistently mapped ring of regions, written in place
+};
+
+// Number of regions a stream buffer is split into. The GPU may still be reading
+// the previous regions while the CPU writes the current one. Writes go one after
+// the other into a region, the ring only moves on once it is full.
+constexpr u32 StreamRegionCount = 3;
+
+// One draw of RenderDevice::DrawIndexedIndirect, laid out as the GL expects it
+struct DrawIndexedCommand
+{
+	u32 IndexCount;
+	u32 InstanceCount;
+	u32 FirstIndex;
+	i32 BaseVertex;
+	u32 BaseInstance;
+};
+
 u32 VertexTypeCount(VertexType type);
 u32 VertexTypeSize(VertexType type);
 
@@ -55,14 +87,43 @@ public:
 
 	static VertexBufferPtr Create(std::initializer_list<Vertex> layout,
 	                              u32                           count,
-	                              u32                           stride);
+	                              u32                           stride,
+	                              BufferUsage usage = BufferUsage::Dynamic);
 
 	virtual const Vector<Vertex>& GetLayout() const              = 0;
 	virtual void SetLayout(std::initializer_list<Vertex> layout) = 0;
 	virtual u32  GetCount() const                                = 0;
+	// Dynamic buffers only, stream buffers are written through Map
 	virtual void SetData(const void* data, u32 count)            = 0;
+	// Dynamic buffers only. Updates count vertices starting at vertex offset.
+	virtual void SetSubData(const void* data, u32 count, u32 offset) = 0;
 	virtual u32  GetStride() const                               = 0;
 	virtual u32  GetID() const                                   = 0;
+
+	virtual BufferUsage GetUsage() const = 0;
+
+	// Stream buffers only. Returns a pointer to the free part of the current
+	// region, room for GetRoom() vertices. Moving on to a region waits until the
+	// GPU is done with what was written there the last time around.
+	virtual void* Map() = 0;
+	// Stream buffers only. Call it after the draws reading the count vertices
+	// written since Map are issued. Fences them, the next Map continues behind
+	// them.
+	virtual void Unmap(u32 count) = 0;
+	// Stream buffers only. Moves on to the next region without a fence once the
+	// current one is full, so one draw call can read several regions. The next
+	// Unmap fences all of them. At most StreamRegionCount - 1 regions can be
+	// written between two Unmap calls, the ring would move on into one of them.
+	virtual void Advance() = 0;
+	// Stream buffers only. Vertices left in the current region.
+	virtual u32 GetRoom() const = 0;
+	// First free vertex of the current region, pass it as base vertex (or base
+	// instance for per instance buffers) to draw calls.
+	virtual u32 GetBaseVertex() const = 0;
+
+	// Binds the whole buffer as shader storage, for shaders that fetch the records
+	// themselves instead of through vertex attributes.
+	virtual void BindStorage(u32 binding) const = 0;
 };
 
 class IndexBuffer
@@ -77,6 +138,52 @@ public:
 	virtual u32  GetID() const                       = 0;
 };
 
+// Persistently mapped ring of draw commands, split into regions like a stream
+// VertexBuffer. The GPU reads the commands when the draw executes, so a region is
+// only rewritten once its fence is signaled.
+class IndirectBuffer
+{
+public:
+	virtual ~IndirectBuffer() = default;
+
+	// count commands per region
+	static IndirectBufferPtr Create(u32 count);
+
+	virtual u32 GetCount() const = 0;
+	virtual u32 GetID() const    = 0;
+
+	// Waits until the GPU is done with the current region and returns it
+	virtual DrawIndexedCommand* Map() = 0;
+	// Fences the current region and moves on to the next one
+	virtual void Unmap() = 0;
+	// Index of the first command of the current region in the whole buffer
+	virtual u32 GetBaseCommand() const = 0;
+};
+
+// Persistently mapped ring of uniform block records, split into regions like
+// a stream VertexBuffer. Records are bound one at a time, each at an offset the
+// GL accepts for a uniform block.
+class UniformBuffer
+{
+public:
+	virtual ~UniformBuffer() = default;
+
+	// count records of size bytes per region
+	static UniformBufferPtr Create(u32 size, u32 count);
+
+	virtual u32 GetCount() const  = 0;
+	virtual u32 GetStride() const = 0;  // bytes from a record to the next
+	virtual u32 GetID() const     = 0;
+
+	// Waits until the GPU is done with the current region and returns it
+	virtual void* Map() = 0;
+	// Fences the current region and moves on to the next one
+	virtual void Unmap() = 0;
+	// Record index of the current region is read by every shader declaring
+	// a uniform block at binding, until another record is bound there
+	virtual void Bind(u32 binding, u32 index) const = 0;
+};
+
 class VertexArray
 {
 public:
@@ -84,8 +191,9 @@ public:
 
 	static VertexArrayPtr Create();
 
-	virtual void AttachIndexBuffer(const IndexBufferPtr& ib)   = 0;
-	virtual void AttachVertexBuffer(const VertexBufferPtr& vb) = 0;
+	virtual void AttachIndexBuffer(const IndexBufferPtr& ib) = 0;
+	// divisor 0 advances the attributes per vertex, n > 0 once every n instances
+	virtual void AttachVertexBuffer(const VertexBufferPtr& vb, u32 divisor = 0) = 0;
 
 	virtual u32             GetVertexBufferCount() const = 0;
 	virtual VertexBufferPtr GetVertexBuffer(u32 i) const = 0;
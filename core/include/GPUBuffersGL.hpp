@@ -5,7 +5,10 @@
 class VertexBufferGL final: public VertexBuffer
 {
 public:
-	VertexBufferGL(std::initializer_list<Vertex> layout, u32 count, u32 stride);
+	VertexBufferGL(std::initializer_list<Vertex> layout,
+	               u32                           count,
+	               u32                           stride,
+	               BufferUsage                   usage);
 	~VertexBufferGL() override;
 
 	const Vector<Vertex>& GetLayout() const override;
@@ -15,11 +18,77 @@ public:
 	u32                   GetStride() const override;
 	u32                   GetID() const override;
 
+	void        SetSubData(const void* data, u32 count, u32 offset) override;
+	BufferUsage GetUsage() const override;
+	void*       Map() override;
+	void        Unmap(u32 count) override;
+	void        Advance() override;
+	u32         GetRoom() const override;
+	u32         GetBaseVertex() const override;
+	void        BindStorage(u32 binding) const override;
+
+private:
+	void ReleaseFence(u32 region);
+
 private:
 	u32            mID {0};
 	Vector<Vertex> mLayout;
 	u32            mCount;
 	u32            mStride;
+	BufferUsage    mUsage;
+
+	u8*                                   mMapped {nullptr};
+	u32                                   mRegion {0};
+	u32                                   mOffset {0};   // vertices used in mRegion
+	u32                                   mPending {0};  // regions without a fence
+	std::array<GLsync, StreamRegionCount> mFences {};   // may be shared, see Unmap
+};
+
+class IndirectBufferGL final: public IndirectBuffer
+{
+public:
+	explicit IndirectBufferGL(u32 count);
+	~IndirectBufferGL() override;
+
+	u32 GetCount() const override;
+	u32 GetID() const override;
+
+	DrawIndexedCommand* Map() override;
+	void                Unmap() override;
+	u32                 GetBaseCommand() const override;
+
+private:
+	u32                 mID {0};
+	u32                 mCount;
+	DrawIndexedCommand* mMapped {nullptr};
+	u32                 mRegion {0};
+
+	std::array<GLsync, StreamRegionCount> mFences {};
+};
+
+class UniformBufferGL final: public UniformBuffer
+{
+public:
+	UniformBufferGL(u32 size, u32 count);
+	~UniformBufferGL() override;
+
+	u32 GetCount() const override;
+	u32 GetStride() const override;
+	u32 GetID() const override;
+
+	void* Map() override;
+	void  Unmap() override;
+	void  Bind(u32 binding, u32 index) const override;
+
+private:
+	u32 mID {0};
+	u32 mCount;
+	u32 mSize;
+	u32 mStride;
+	u8* mMapped {nullptr};
+	u32 mRegion {0};
+
+	std::array<GLsync, StreamRegionCount> mFences {};
 };
 
 class IndexBufferGL final: public IndexBuffer
@@ -40,11 +109,11 @@ private:
 class VertexArrayGL final: public VertexArray
 {
 public:
-	VertexArrayGL();
+	VertexArrayGL() = default;
 	~VertexArrayGL() override;
 
 	void AttachIndexBuffer(const IndexBufferPtr& ib) override;
-	void AttachVertexBuffer(const VertexBufferPtr& vb) override;
+	void AttachVertexBuffer(const VertexBufferPtr& vb, u32 divisor = 0) override;
 
 	u32             GetVertexBufferCount() const override;
 	VertexBufferPtr GetVertexBuffer(u32 i) const override;
@@ -56,9 +125,17 @@ public:
 private:
 	static u32 VertexTypeMap(VertexType type);
 
+	// On first Bind, in the context that draws with it, see
+	// RenderDeviceGL::ContainerType
+	void Create() const;
+	void SetupVertexBuffer(const VertexBufferPtr& vb, u32 divisor) const;
+
 private:
-	u32                     mID {0};
+	mutable u32             mID {0};
+	mutable std::thread::id mOwner;
 	IndexBufferPtr          mIB;
 	Vector<VertexBufferPtr> mVBList;
-	u32                     mVBIndex {0};
+	Vector<u32>             mDivisors;
+	mutable u32             mVBIndex {0};
+	mutable u32             mAttribIndex {0};
 };
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <GPUBuffers.hpp>
+
+// Stream buffers keep their ring in CPU memory, everything else only its size
+class VertexBufferNull final: public VertexBuffer
+{
+public:
+	VertexBufferNull(std::initializer_list<Vertex> layout,
+	                 u32                           count,
+	                 u32                           stride,
+	                 BufferUsage                   usage);
+
+	const Vector<Vertex>& GetLayout() const override;
+	void                  SetLayout(std::initializer_list<Vertex> layout) override;
+	u32                   GetCount() const override;
+	void                  SetData(const void* data, u32 count) override;
+	u32                   GetStride() const override;
+	u32                   GetID() const override;
+
+	void        SetSubData(const void* data, u32 count, u32 offset) override;
+	BufferUsage GetUsage() const override;
+	void*       Map() override;
+	void        Unmap(u32 count) override;
+	void        Advance() override;
+	u32         GetRoom() const override;
+	u32         GetBaseVertex() const override;
+	void        BindStorage(u32 binding) const override;
+
+private:
+	u32            mID;
+	Vector<Vertex> mLayout;
+	u32            mCount;
+	u32            mStride;
+	BufferUsage    mUsage;
+
+	Vector<u8> mMemory;  // stream buffers, all regions
+	u32        mRegion {0};
+	u32        mOffset {0};
+	u32        mPending {0};
+};
+
+class IndirectBufferNull final: public IndirectBuffer
+{
+public:
+	explicit IndirectBufferNull(u32 count);
+
+	u32 GetCount() const override;
+	u32 GetID() const override;
+
+	DrawIndexedCommand* Map() override;
+	void                Unmap() override;
+	u32                 GetBaseCommand() const override;
+
+	// All regions, for the null device to count what a draw submits
+	const DrawIndexedCommand* GetCommands() const;
+
+private:
+	u32                        mID;
+	u32                        mCount;
+	Vector<DrawIndexedCommand> mCommands;
+	u32                        mRegion {0};
+};
+
+class UniformBufferNull final: public UniformBuffer
+{
+public:
+	UniformBufferNull(u32 size, u32 count);
+
+	u32 GetCount() const override;
+	u32 GetStride() const override;
+	u32 GetID() const override;
+
+	void* Map() override;
+	void  Unmap() override;
+	void  Bind(u32 binding, u32 index) const override;
+
+private:
+	u32        mID;
+	u32        mCount;
+	u32        mStride;
+	Vector<u8> mRecords;
+	u32        mRegion {0};
+};
+
+class IndexBufferNull final: public IndexBuffer
+{
+public:
+	IndexBufferNull(const u32* data, u32 count);
+
+	u32  GetCount() const override;
+	void SetData(const u32* data, u32 count) override;
+	u32  GetID() const override;
+
+private:
+	u32 mID;
+	u32 mCount {0};
+};
+
+class VertexArrayNull final: public VertexArray
+{
+public:
+	VertexArrayNull() = default;
+
+	void AttachIndexBuffer(const IndexBufferPtr& ib) override;
+	void AttachVertexBuffer(const VertexBufferPtr& vb, u32 divisor = 0) override;
+
+	u32             GetVertexBufferCount() const override;
+	VertexBufferPtr GetVertexBuffer(u32 i) const override;
+	IndexBufferPtr  GetIndexBuffer() const override;
+
+	void Bind() const override;
+	void Unbind() const override;
+
+private:
+	IndexBufferPtr          mIB;
+	Vector<VertexBufferPtr> mVBList;
+};
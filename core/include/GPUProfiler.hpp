@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Common.hpp>
+#include <TimerQuery.hpp>
+
+// Named GPU time zones. Every frame uses its own queries from a ring FrameLatency
+// frames deep and reads them when the ring comes around again, so getting the
+// results never waits for the GPU. If the GPU is that far behind, the frame is
+// not measured instead. Zones may nest, zones with the same name are summed.
+class GPUProfiler
+{
+public:
+	struct Zone
+	{
+		const char* Name;  // as passed to BeginZone
+		double      Time;  // milliseconds
+		u32         Count;
+	};
+
+	static constexpr u32 FrameLatency = 4;
+
+	// Zones past max_zones in a frame are ignored
+	explicit GPUProfiler(u32 max_zones = 256);
+	GPUProfiler(const GPUProfiler&)            = delete;
+	GPUProfiler& operator=(const GPUProfiler&) = delete;
+
+	void BeginFrame();
+	void EndFrame();
+
+	// name must outlive the profiler, string literals are the intended use
+	void BeginZone(const char* name);
+	void EndZone();
+
+	// Results of the most recent frame the GPU has finished, in milliseconds
+	double GetFrameTime() const
+	{
+		return mFrameTime;
+	}
+
+	// Zones of that frame in the order they first began
+	const Vector<Zone>& GetZones() const
+	{
+		return mZones;
+	}
+
+private:
+	struct Frame
+	{
+		TimerQueryPtr         Elapsed;  // whole frame
+		Vector<TimerQueryPtr> Stamps;   // begin and end of each zone
+		Vector<const char*>   Names;
+		bool                  Pending;  // issued, results not read yet
+	};
+
+	bool IsDone(const Frame& frame) const;
+	void Collect(Frame& frame);
+
+private:
+	u32  mMaxZones;
+	u32  mFrameIndex;
+	bool mMeasuring;  // the current frame has queries
+
+	Vector<Frame> mFrames;
+	Vector<u32>   mOpenZones;  // zones begun and not ended, ~0u if ignored
+
+	double       mFrameTime;
+	Vector<Zone> mZones;
+};
@@ -18,6 +18,45 @@ constexpr double Rad2Deg(double radian)
 	return radian * C180_PI;
 }
 
+// IEEE 754 binary16 bits of value, rounded to nearest even. Out of range values
+// become infinity, tiny ones subnormals or zero.
+inline u16 FloatToHalf(float value)
+{
+	u32 f;
+	std::memcpy(&f, &value, sizeof(f));
+
+	u32 sign     = (f >> 16) & 0x8000;
+	u32 mantissa = f & 0x7fffff;
+	i32 exponent = i32((f >> 23) & 0xff) - 127 + 15;
+
+	if(((f >> 23) & 0xff) == 0xff)  // inf, nan
+		return u16(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+	if(exponent >= 31)
+		return u16(sign | 0x7c00);
+
+	if(exponent <= 0)
+	{
+		if(exponent < -10)
+			return u16(sign);
+
+		mantissa |= 0x800000;
+		u32 shift = u32(14 - exponent);
+		u32 rest  = mantissa & ((1u << shift) - 1);
+		u32 tie   = 1u << (shift - 1);
+		u32 half  = mantissa >> shift;
+		if(rest > tie || (rest == tie && (half & 1)))  // ties to even
+			++half;
+		return u16(sign | half);
+	}
+
+	// a carry out of the mantissa correctly bumps the exponent
+	u32 rest = mantissa & 0x1fff;
+	u32 half = sign | (u32(exponent) << 10) | (mantissa >> 13);
+	if(rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+		++half;
+	return u16(half);
+}
+
 // clang-format off
 template<typename T>
 constexpr typename std::enable_if_t<std::is_floating_point_v<T>, T>
@@ -2,13 +2,18 @@
 
 #include <Color.hpp>
 #include <Common.hpp>
+#include <Framebuffer.hpp>
 #include <GPUBuffers.hpp>
 #include <Texture.hpp>
+#include <Vector2.hpp>
 
 class Window;
 class WindowSettings;
 using RenderDevicePtr = UniquePtr<class RenderDevice>;
 
+// A point in the commands of a context, see RenderDevice::CreateFence
+using GPUFence = void*;
+
 enum class RenderAPI
 {
 	None,
@@ -32,6 +37,7 @@ struct RenderDeviceInfo
 	bool    PVRTC;            // PowerVR texture compression
 	bool    BC4BC5;           // BC4 and BC5
 	bool    BC6HBC7;          // BC6H and BC7
+	bool    ParallelCompile;  // shaders compile in the background, see Shader
 	u32     NumTextureUnits;  // number of available texture samplers in fragment
 	                          // shader
 	u32 MaxTextureWidth;
@@ -65,9 +71,12 @@ public:
 	RenderDevice& operator=(const RenderDevice&) = delete;
 	virtual ~RenderDevice()                      = default;
 
-	static RenderDevicePtr Create();
+	// For the context of window, current on this thread
+	static RenderDevicePtr Create(const Window& window);
 
 	static RenderAPI        GetAPI();
+	// Before the window and any other render object are created
+	static void             SetAPI(RenderAPI api);
 	const RenderDeviceInfo& GetInfo() const;
 
 	virtual void SetClearColor(Color color) = 0;
@@ -75,13 +84,51 @@ public:
 
 	virtual void EnableBlending(bool enable)                             = 0;
 	virtual void SetBlendFunc(BlendFunc src, BlendFunc dst, Color color) = 0;
+	virtual void SetBlendFuncSeparate(BlendFunc src_color,
+	                                  BlendFunc dst_color,
+	                                  BlendFunc src_alpha,
+	                                  BlendFunc dst_alpha,
+	                                  Color     color)                     = 0;
 	virtual bool IsBlendingEnable() const                                = 0;
 
-	virtual void UpdateViewport(u32 x, u32 y, u32 width, u32 height) = 0;
+	// Viewport of the window, applied whenever no render target is set
+	virtual void   UpdateViewport(u32 x, u32 y, u32 width, u32 height) = 0;
+	virtual vec2ui GetViewportSize() const                            = 0;
+	// Draws and Clear go to target, or to the window if null. The viewport covers
+	// the whole target.
+	virtual void                  SetRenderTarget(const FramebufferPtr& target) = 0;
+	virtual const FramebufferPtr& GetRenderTarget() const                       = 0;
+	// What a headless window renders to in place of the window, null otherwise
+	virtual const FramebufferPtr& GetBackBuffer() const = 0;
 
 	virtual void SetPointSize(float size) = 0;
 
-	virtual void DrawIndexed(const VertexArrayPtr& va, u32 index_count) = 0;
+	// Sends the commands issued on this thread to the GPU. Contexts sharing objects
+	// with this one see what they changed afterwards, see RenderThread.
+	virtual void Flush() = 0;
+	// Flush with a fence after the commands issued on this thread. WaitFence on
+	// a context sharing objects with this one holds its later commands back on
+	// the GPU until those are done, and deletes the fence.
+	virtual GPUFence CreateFence()             = 0;
+	virtual void     WaitFence(GPUFence fence) = 0;
+
+	// Non-indexed, for shaders that derive everything from gl_VertexID
+	virtual void Draw(const VertexArrayPtr& va,
+	                  u32                   vertex_count,
+	                  u32                   first_vertex = 0) = 0;
+	virtual void DrawIndexed(const VertexArrayPtr& va,
+	                         u32                   index_count,
+	                         u32                   base_vertex = 0) = 0;
+	virtual void DrawIndexedInstanced(const VertexArrayPtr& va,
+	                                  u32                   index_count,
+	                                  u32                   instance_count,
+	                                  u32                   base_instance = 0) = 0;
+	// Executes count commands of the indirect buffer starting at command first,
+	// all of them with a single API call
+	virtual void DrawIndexedIndirect(const VertexArrayPtr&    va,
+	                                 const IndirectBufferPtr& commands,
+	                                 u32                      first,
+	                                 u32                      count) = 0;
 
 private:
 	static RenderAPI sAPI;
@@ -5,21 +5,67 @@
 class RenderDeviceGL: public RenderDevice
 {
 public:
-	RenderDeviceGL();
+	explicit RenderDeviceGL(const Window& window);
 
 	void SetClearColor(Color color) override;
 	void Clear() override;
 
 	void EnableBlending(bool enable) override;
 	void SetBlendFunc(BlendFunc src, BlendFunc dst, Color color) override;
+	void SetBlendFuncSeparate(BlendFunc src_color,
+	                          BlendFunc dst_color,
+	                          BlendFunc src_alpha,
+	                          BlendFunc dst_alpha,
+	                          Color     color) override;
 	bool IsBlendingEnable() const override;
 
-	void UpdateViewport(u32 x, u32 y, u32 width, u32 height) override;
+	void   UpdateViewport(u32 x, u32 y, u32 width, u32 height) override;
+	vec2ui GetViewportSize() const override;
+	void SetRenderTarget(const FramebufferPtr& target) override;
+	const FramebufferPtr& GetRenderTarget() const override;
+	const FramebufferPtr& GetBackBuffer() const override;
 
 	void SetPointSize(float size) override;
 
-	void DrawIndexed(const VertexArrayPtr& va, u32 index_count) override;
+	void     Flush() override;
+	GPUFence CreateFence() override;
+	void     WaitFence(GPUFence fence) override;
+
+	void Draw(const VertexArrayPtr& va,
+	          u32                   vertex_count,
+	          u32                   first_vertex = 0) override;
+	void DrawIndexed(const VertexArrayPtr& va,
+	                 u32                   index_count,
+	                 u32                   base_vertex = 0) override;
+	void DrawIndexedInstanced(const VertexArrayPtr& va,
+	                          u32                   index_count,
+	                          u32                   instance_count,
+	                          u32                   base_instance = 0) override;
+	void DrawIndexedIndirect(const VertexArrayPtr&    va,
+	                         const IndirectBufferPtr& commands,
+	                         u32                      first,
+	                         u32                      count) override;
+
+	// Vertex arrays and framebuffers are not shared between contexts. They are
+	// created by the thread that first uses them and deleted there, one released
+	// on another thread waits until its thread creates the next.
+	enum class ContainerType
+	{
+		VertexArray,
+		Framebuffer
+	};
+
+	static void DeleteContainer(ContainerType type, u32 id, std::thread::id owner);
+	static void DeleteOrphans();
 
 private:
 	static i32 BlendFuncMap(BlendFunc func);
+	// the back buffer or the window's framebuffer
+	void BindDefaultTarget();
+
+private:
+	vec2ui         mViewportPosition;
+	vec2ui         mViewportSize;
+	FramebufferPtr mRenderTarget;
+	FramebufferPtr mBackBuffer;
 };
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <RenderDevice.hpp>
+
+// What the null backend saw, see RenderDeviceNull::SetRecording
+enum class NullCommandType : u8
+{
+	Clear,
+	SetBlend,
+	SetRenderTarget,
+	SetViewport,
+	Draw,
+	DrawIndexed,
+	DrawIndexedInstanced,
+	DrawIndexedIndirect,
+	BindShader,
+	BindTexture,
+	UploadBuffer,
+	UploadTexture
+};
+
+struct NullCommand
+{
+	NullCommandType Type;
+	u32             Object;     // id of the buffer, texture, shader, ...
+	u32             Count;      // vertices or indices for draws, bytes for uploads
+	u32             Instances;  // draws only
+};
+
+struct NullDeviceCounters
+{
+	u64 DrawCalls;     // API calls, an indirect draw counts once
+	u64 DrawCommands;  // including every command of indirect draws
+	u64 Vertices;      // vertices or indices of all instances
+	u64 Instances;
+	u64 StateChanges;  // blending, render target and viewport
+	u64 Clears;
+	u64 ShaderBinds;
+	u64 TextureBinds;
+	u64 BufferBytes;   // through SetData and SetSubData, not mapped writes
+	u64 TextureBytes;
+};
+
+// RenderAPI::None. Accepts every call without a GPU, the objects of the backend
+// keep their sizes and CPU copies of mapped memory so the renderer behaves as
+// with a real device. Counts what is submitted and optionally records a compact
+// command log, for profiling and regression tracking of the CPU side with
+// timings free of driver noise.
+class RenderDeviceNull final: public RenderDevice
+{
+public:
+	RenderDeviceNull();
+	~RenderDeviceNull() override;
+
+	void SetClearColor(Color color) override;
+	void Clear() override;
+
+	void EnableBlending(bool enable) override;
+	void SetBlendFunc(BlendFunc src, BlendFunc dst, Color color) override;
+	void SetBlendFuncSeparate(BlendFunc src_color,
+	                          BlendFunc dst_color,
+	                          BlendFunc src_alpha,
+	                          BlendFunc dst_alpha,
+	                          Color     color) override;
+	bool IsBlendingEnable() const override;
+
+	void   UpdateViewport(u32 x, u32 y, u32 width, u32 height) override;
+	vec2ui GetViewportSize() const override;
+	void SetRenderTarget(const FramebufferPtr& target) override;
+	const FramebufferPtr& GetRenderTarget() const override;
+	const FramebufferPtr& GetBackBuffer() const override;
+
+	void SetPointSize(float size) override;
+
+	void     Flush() override;
+	GPUFence CreateFence() override;
+	void     WaitFence(GPUFence fence) override;
+
+	void Draw(const VertexArrayPtr& va,
+	          u32                   vertex_count,
+	          u32                   first_vertex = 0) override;
+	void DrawIndexed(const VertexArrayPtr& va,
+	                 u32                   index_count,
+	                 u32                   base_vertex = 0) override;
+	void DrawIndexedInstanced(const VertexArrayPtr& va,
+	                          u32                   index_count,
+	                          u32                   instance_count,
+	                          u32                   base_instance = 0) override;
+	void DrawIndexedIndirect(const VertexArrayPtr&    va,
+	                         const IndirectBufferPtr& commands,
+	                         u32                      first,
+	                         u32                      count) override;
+
+	// Off by default, the log grows until ClearCommands
+	void SetRecording(bool enable);
+	bool IsRecording() const;
+
+	const Vector<NullCommand>& GetCommands() const;
+	void                       ClearCommands();
+
+	const NullDeviceCounters& GetCounters() const;
+	void                      ResetCounters();
+
+	// For the objects of the backend, goes to the live device if there is one
+	// commands counts the draws of a multi draw, 1 for anything else
+	static void Record(NullCommandType type,
+	                   u32             object,
+	                   u32             count,
+	                   u32             instances = 0,
+	                   u32             commands  = 1);
+	// Object ids, unique like GL names and never 0
+	static u32 GenerateID();
+
+private:
+	bool           mBlending {false};
+	bool           mRecording {false};
+	FramebufferPtr mRenderTarget;
+	FramebufferPtr mBackBuffer;  // always null
+	vec2ui         mViewportSize;
+
+	Vector<NullCommand> mCommands;
+	NullDeviceCounters  mCounters {};
+};
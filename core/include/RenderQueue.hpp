@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Color.hpp>
+#include <Common.hpp>
+#include <Texture.hpp>
+#include <Transform.hpp>
+#include <Vector2.hpp>
+
+enum class BlendMode : u8
+{
+	Alpha,
+	Additive,
+	Premultiplied  // color already multiplied by alpha, e.g. a cached layer
+};
+
+// Also selects the shader, so it is part of the sort key
+enum class PrimitiveType : u8
+{
+	Quad,
+	Shape,       // any ShapeType, one pipeline for all of them
+	StaticBatch  // a whole retained batch, drawn on its own
+};
+
+// Distance functions of the shape shader. Each shape lives in its own local space,
+// the model transform of the command places it.
+enum class ShapeType : u8
+{
+	Circle,   // radius in Params[0]
+	Box,      // half size in Params[0, 1], corner radius in Params[2]
+	Capsule,  // segment (-Params[0], 0) to (Params[0], 0), radius in Params[1]
+	Triangle  // (0, 0), (Params[0], Params[1]) and (Params[2], Params[3])
+};
+
+struct RenderCommand
+{
+	Transform     Model;  // shapes: local space of the shape to world
+	vec2          UVMin;
+	vec2          UVMax;
+	Texture*      Texture;  // not owned, the renderer's pass holds a reference
+	u32           ArrayLayer;
+	Color         Color;
+	float         Thickness;  // shapes: outline width in local units, 0 fills
+	float         Smoothness;
+	float         Params[4];
+	ShapeType     Shape;
+	PrimitiveType Type;
+};
+
+// Draws recorded during a frame. Sorting by a 64-bit key groups commands by
+// layer, depth and then state, so they can be emitted with the fewest batches.
+//
+// key layout (msb to lsb):
+//   layer 8 | depth 16 | blend 4 | primitive 4 | texture 32
+//
+// For static batches the texture bits hold the index of the batch instead.
+class RenderQueue
+{
+public:
+	RenderQueue()                              = default;
+	RenderQueue(const RenderQueue&)            = delete;
+	RenderQueue& operator=(const RenderQueue&) = delete;
+
+	static u64 MakeKey(u8            layer,
+	                   u16           depth,
+	                   BlendMode     blend,
+	                   PrimitiveType type,
+	                   u32           texture);
+
+	static BlendMode GetBlendMode(u64 key)
+	{
+		return static_cast<BlendMode>((key >> 36) & 0xf);
+	}
+
+	static u32 GetTextureID(u64 key)
+	{
+		return static_cast<u32>(key);
+	}
+
+	void Reserve(u32 count);
+	void Clear();
+
+	// Returns the command to fill in
+	RenderCommand& Push(u64 key);
+
+	// LSD radix sort of the keys, stable so equal keys keep submission order
+	void Sort();
+
+	u32 GetSize() const
+	{
+		return u32(mItems.size());
+	}
+
+	bool IsEmpty() const
+	{
+		return mItems.empty();
+	}
+
+	// Sort key of the i-th command in sorted order
+	u64 GetKey(u32 i) const
+	{
+		return mItems[i].Key;
+	}
+
+	// i-th command in sorted order, valid after Sort()
+	const RenderCommand& operator[](u32 i) const
+	{
+		return mCommands[mItems[i].Index];
+	}
+
+private:
+	struct SortItem
+	{
+		u64 Key;
+		u32 Index;
+	};
+
+	Vector<RenderCommand> mCommands;
+	Vector<SortItem>      mItems;
+	Vector<SortItem>      mScratch;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Common.hpp>
+
+class Window;
+
+// Runs rendering work on its own thread, which owns the window's context while the
+// RenderThread exists. The thread that created it gets a context sharing objects
+// with the window's, so textures, buffers and shaders can still be created and
+// updated there. Everything else that talks to the device, drawing included, is
+// submitted here. Work runs in submission order.
+class RenderThread
+{
+public:
+	using Job = std::function<void()>;
+
+	// The window's context has to be current on the calling thread
+	explicit RenderThread(Window& window);
+	RenderThread(const RenderThread&)            = delete;
+	RenderThread& operator=(const RenderThread&) = delete;
+	// Finishes the submitted work, the context is current on the calling thread
+	// again
+	~RenderThread();
+
+	// Returns a ticket to wait for
+	u64 Submit(Job job);
+	// Blocks until the job of the ticket ran, 0 waits for everything submitted
+	void Wait(u64 ticket = 0);
+
+	// Queues the buffer swap, then waits for the previous one. The caller stays at
+	// most one frame ahead of the render thread.
+	void Present();
+
+	// Frames presented by the render thread
+	u64 GetFrameCount() const
+	{
+		return mFrameCount;
+	}
+
+private:
+	void Run();
+	void Swap();
+
+private:
+	Window& mWindow;
+
+	std::mutex              mMutex;
+	std::condition_variable mQueued;  // a job was submitted or the thread stops
+	std::condition_variable mDone;    // a job finished
+	std::deque<Job>         mJobs;
+	u64                     mSubmitted {0};
+	u64                     mCompleted {0};
+	u64                     mPresented {0};  // ticket of the last Present
+	bool                    mStopping {false};
+
+	std::atomic<u64> mFrameCount {0};
+	std::thread      mThread;  // last, starts once the rest is initialized
+};
@@ -4,18 +4,62 @@
 #include <Color.hpp>
 #include <Common.hpp>
 #include <GPUBuffers.hpp>
+#include <GPUProfiler.hpp>
 #include <RenderDevice.hpp>
+#include <RenderQueue.hpp>
 #include <Shader.hpp>
 #include <Texture.hpp>
+#include <TextureSlots.hpp>
+#include <Timer.hpp>
 #include <Transform.hpp>
 #include <Vector2.hpp>
 
 class Window;
+class StaticBatch;
+class CachedLayer;
+class RenderThread;
+
+// The quad shaders sample 2D textures from units [0, QuadTextureSlots) and array
+// textures from the QuadArraySlots units after them. Devices with fewer texture
+// units get fewer slots, see Renderer::GetTextureSlots.
+constexpr u32 QuadTextureSlots = 28;
+constexpr u32 QuadArraySlots   = 4;
+
+// Frame block of the shaders at FrameUniformBinding, see shaders/include/Frame.glsl
+struct FrameUniforms
+{
+	float ViewProjection[2][4];  // rows, padded like std140 does
+	vec2  Viewport;
+	float Time;
+	float Padding;
+};
 
 struct FrameStats
 {
-	u32 DrawCalls;
-	u32 QuadCount;
+	u32 DrawCalls;  // API calls, a multi draw counts once
+	u32 Batches;    // logical batches, several may share a draw call
+	u32 QuadCount;  // sprites and quads, static batches included
+	u32 ShapeCount;
+	u32 VertexBytes;   // written to vertex buffers, static batch uploads included
+	u32 VisibleCount;  // reported by the scene, see Renderer::SetCullStats
+	u32 CulledCount;
+
+	// why batches were flushed
+	u32 TextureFlushes;   // texture slots full
+	u32 CapacityFlushes;  // vertex buffer full
+	u32 StateFlushes;     // blend mode or primitive type changed
+	u32 QueueFlushes;     // end of the queue, Flush or DrawEnd
+
+	u32 TextureBinds;
+	u32 ShaderBinds;
+
+	// CPU time in milliseconds. Submission covers the Draw* calls and is only
+	// measured with RendererSettings::TimeSubmission.
+	double SubmitTime;
+	double FlushTime;
+	// GPU milliseconds from DrawBegin to DrawEnd, GPUProfiler::FrameLatency frames
+	// old. 0 without RendererSettings::GPUTiming.
+	double GPUTime;
 };
 
 struct QuadVertex
@@ -24,34 +68,204 @@ struct QuadVertex
 	vec2  UV;
 	Color Color;
 	float TexID;
+	float ArrayLayer;  // only read when TexID is an array texture slot
 };
 
-struct CircleVertex
+// QuadVertex with RendererSettings::CompactVertices, 20 bytes instead of 28.
+// UVs are normalized shorts clamped to [0, 1], slot and layer half floats which
+// the quad shader reads unchanged.
+struct QuadVertexCompact
+{
+	vec2  Position;
+	u16   UV[2];
+	Color Color;
+	u16   TexID;
+	u16   ArrayLayer;
+};
+
+struct ShapeVertex
 {
 	vec2  WorldPosition;
 	vec2  LocalPosition;
 	Color Color;
+	float Params[4];  // see ShapeType
 	float Thickness;
 	float Smoothness;
+	float Type;
+};
+
+// Per instance record of BatchMode::Instanced, the vertex shader expands the unit
+// quad. 52 bytes per sprite instead of 4 * sizeof(QuadVertex).
+struct QuadInstance
+{
+	Transform Model;
+	vec2      UVMin;
+	vec2      UVMax;
+	Color     Color;
+	float     TexID;
+	float     ArrayLayer;
+};
+
+// ShapeVertex with RendererSettings::CompactVertices, 32 bytes instead of 48.
+// Everything but the world position is a half float, exact enough for shapes up to
+// a few hundred units across.
+struct ShapeVertexCompact
+{
+	vec2  WorldPosition;
+	u16   LocalPosition[2];
+	Color Color;
+	u16   Params[4];
+	u16   Thickness;
+	u16   Smoothness;
+	u16   Type;
+};
+
+// Per instance record of a shape, the vertex shader expands its local bounds
+struct ShapeInstance
+{
+	Transform Model;
+	vec2      BoundsMin;
+	vec2      BoundsMax;
+	Color     Color;
+	float     Params[4];
+	float     Thickness;
+	float     Smoothness;
+	float     Type;
+};
+
+// One sprite of a bulk submission, see Renderer::DrawQuads
+struct SpriteInstance
+{
+	vec2              Position;
+	vec2              Size;
+	float             Rotation;  // degrees, around the center
+	Color             Color;
+	u8                Layer;
+	const SubTexture* Sprite;  // nullptr draws a solid quad
+};
+
+enum class BatchMode
+{
+	Vertex,     // four vertices per primitive, transformed on the CPU
+	Instanced,  // one record per primitive, expanded in the vertex shader
+	Pulling     // instance records fetched from a storage buffer, no attributes,
+	            // no index buffer. Batches are not merged by MultiDraw.
+};
+
+struct RendererSettings
+{
+	// Primitives per region of the stream buffers, separately for quads and
+	// shapes. Batches follow each other in a region, which should hold a frame. A
+	// frame drawing more doubles the capacity, up to MaxQuadsLimit. After
+	// ShrinkFrames frames using less than a quarter of it, it halves again, not
+	// below MaxQuads. MaxQuadsLimit <= MaxQuads keeps it fixed, ShrinkFrames 0
+	// never shrinks.
+	u32 MaxQuads {2048};
+	u32 MaxQuadsLimit {65536};
+	u32 ShrinkFrames {600};
+
+	BatchMode Mode {BatchMode::Vertex};
+	// Batches that only split because they ran out of room are drawn together
+	// by one glMultiDrawElementsIndirect call
+	bool MultiDraw {true};
+	// BatchMode::Vertex only. Quantized vertex layouts, less bandwidth per frame.
+	bool CompactVertices {false};
+	// Pixels the edges of shapes fade over at least. A specialization constant of
+	// ShapeShader, every value shares its SPIR-V module.
+	float ShapeEdgeWidth {1.0f};
+
+	// Frames kept by Renderer::GetStatsHistory
+	u32 StatsHistory {300};
+	// Reads the clock twice per Draw* call, noticeable with many sprites
+	bool TimeSubmission {false};
+	// GPU timer queries around the flushes, see Renderer::GetGPUProfiler
+	bool GPUTiming {true};
+	// Frames begun before the shaders finished compiling are skipped, they clear
+	// but draw nothing. Set, the first draw waits for the shaders instead.
+	bool WaitForShaders {false};
 };
 
 class Renderer
 {
 public:
-	Renderer(RenderDevicePtr& device, u32 max_quads);
+	Renderer(RenderDevicePtr& device, const RendererSettings& settings);
 	Renderer(const Renderer&)            = delete;
 	Renderer& operator=(const Renderer&) = delete;
 	~Renderer();
 
+	// Draws between DrawBegin and DrawEnd are queued, sorted by layer, depth and
+	// state, then emitted with as few batches as possible. Draws with the same
+	// layer and depth may be reordered, use them to control overlap.
+	// Textures are referenced, not copied, keep them alive until DrawEnd, with
+	// a render thread until the next DrawEnd.
 	void DrawBegin(const Transform& view_projection);
 	void DrawEnd();
+	// Sorts and draws everything queued so far. DrawEnd calls it. With a render
+	// thread it only ends a pass, drawn in order with the rest of the frame.
 	void Flush();
+	// Clears the render target with the device's clear color, after what is
+	// queued so far. Before DrawBegin it clears at the start of the frame.
+	// Unlike RenderDevice::Clear it stays in order with a render thread.
+	void Clear();
+
+	// From now on frames are drawn by thread, the DrawEnd of a frame returns once
+	// the frame before it is drawn. Null draws on the calling thread again.
+	// Static batches are copied when queued and uploaded by the thread.
+	void SetRenderThread(RenderThread* thread);
+	// Waits until the render thread has drawn every frame that ended
+	void Sync();
 
+	// Counters of the last frame drawn. Without a render thread that is the one
+	// the last DrawEnd ended, with one the frame before unless after Sync.
 	const FrameStats& GetFrameStats() const
 	{
 		return mStats;
 	}
 
+	// Counters of the last frames, age 0 is the last one that ended
+	const FrameStats& GetStatsHistory(u32 age) const;
+
+	u32 GetStatsHistorySize() const
+	{
+		return mHistoryCount;
+	}
+
+	// Logs the average and worst frame of the history
+	void LogStatsSummary() const;
+
+	// Texture units the quad shaders sample 2D textures from, the array slots
+	// follow. At most QuadTextureSlots and QuadArraySlots, less if the device has
+	// fewer units.
+	u32 GetTextureSlots() const
+	{
+		return mTextureSlotCount;
+	}
+
+	u32 GetArraySlots() const
+	{
+		return mArraySlotCount;
+	}
+
+	// The texture of untextured quads, slot 0 of every batch
+	const TexturePtr& GetWhiteTexture() const
+	{
+		return mWhiteTexture;
+	}
+
+	// GPU zones "Flush", "Quads", "Shapes" and "Static". Null without
+	// RendererSettings::GPUTiming. A render thread updates it, read it after Sync.
+	const GPUProfiler* GetGPUProfiler() const
+	{
+		return mProfiler.get();
+	}
+
+	// Culling happens before submission, the caller reports its result here
+	void SetCullStats(u32 visible, u32 culled)
+	{
+		mFrame->Stats.VisibleCount = visible;
+		mFrame->Stats.CulledCount  = culled;
+	}
+
 	void SetColor(Color color)
 	{
 		mColor = color;
@@ -65,9 +279,41 @@ public:
 		return mColor;
 	}
 
+	// Layers are drawn in increasing order
+	void SetLayer(u8 layer)
+	{
+		mLayer = layer;
+	}
+	u8 GetLayer() const
+	{
+		return mLayer;
+	}
+
+	// Depth in [0, 1] inside a layer, greater depth is drawn first (further back)
+	void SetDepth(float depth)
+	{
+		mDepth = depth;
+	}
+	float GetDepth() const
+	{
+		return mDepth;
+	}
+
+	void SetBlendMode(BlendMode mode)
+	{
+		mBlendMode = mode;
+	}
+	BlendMode GetBlendMode() const
+	{
+		return mBlendMode;
+	}
+
 	void DrawQuad(const TexturePtr& texture, const Transform& model, const vec2* uv);
 	void DrawQuad(const TexturePtr& texture, vec2 position, vec2 size);
 	void DrawQuad(vec2 position, vec2 size);
+	// Draws a region of a texture, e.g. a TextureAtlas entry
+	void DrawQuad(const SubTexture& sprite, const Transform& model);
+	void DrawQuad(const SubTexture& sprite, vec2 position, vec2 size);
 
 	void DrawRotatedQuad(const TexturePtr& texture,
 	                     vec2              position,
@@ -78,48 +324,250 @@ public:
 	                     vec2              position,
 	                     vec2              size,
 	                     float             rotation);
+	void DrawRotatedQuad(const SubTexture& sprite,
+	                     vec2              position,
+	                     vec2              size,
+	                     float             rotation);
 	void DrawRotatedQuad(vec2 position, vec2 size, float rotation, vec2 origin);
 	void DrawRotatedQuad(vec2 position, vec2 size, float rotation);
 
+	// Bulk version of DrawRotatedQuad. Rotations are evaluated several sprites at
+	// a time and the model transforms are built directly, much cheaper than
+	// a DrawRotatedQuad call per sprite. Uses the current depth and blend mode.
+	void DrawQuads(const SpriteInstance* sprites, u32 count);
+
+	// Draws a retained batch as a single draw call, at its layer and the current
+	// depth and blend mode. Changed sprites are uploaded first.
+	void DrawStaticBatch(StaticBatch& batch);
+
+	// Draws between these go into the layer's framebuffer instead, seen through
+	// view_projection. Anything queued before is drawn first, so render invalid
+	// layers right after DrawBegin. EndCachedLayer marks the layer valid.
+	void BeginCachedLayer(CachedLayer& layer, const Transform& view_projection);
+	void EndCachedLayer();
+	// A single quad covering the area the layer was rendered from, at its layer
+	// and the current depth
+	void DrawCachedLayer(const CachedLayer& layer);
+
+	// Shapes are signed distance fields evaluated per pixel. They share a single
+	// batch whatever their type, so mixing them costs no extra draw calls.
+	// thickness is the outline width, 0 fills the shape.
+
+	// The circle fills a radius sized quad. thickness and smoothness are relative
+	// to its size, a thickness below 1 draws a ring.
 	void DrawCircle(vec2  position,
 	                float radius,
 	                float thickness  = 1.0f,
 	                float smoothness = 0.03f);
+	void DrawRoundedRect(vec2  position,
+	                     vec2  size,
+	                     float corner_radius,
+	                     float rotation  = 0.0f,
+	                     float thickness = 0.0f);
+	void DrawCapsule(vec2 a, vec2 b, float radius, float thickness = 0.0f);
+	void DrawLine(vec2 a, vec2 b, float width);
+	void DrawTriangle(vec2 a, vec2 b, vec2 c, float thickness = 0.0f);
+
+private:
+	// A static batch as it was when queued, the batch itself may change before it
+	// is drawn
+	struct StaticDraw
+	{
+		VertexArrayPtr  VA;
+		VertexBufferPtr VB;
+		u32             QuadCount;
+		u32             FirstTexture;  // in RenderPass::StaticTextures
+		u32             TextureCount;
+		u32             FirstVertex;   // of the changed vertices in the buffer
+		u32             FirstChange;   // in RenderPass::StaticChanges
+		u32             ChangeCount;
+	};
+
+	// Draws between two flushes, all to one target with one view projection
+	struct RenderPass
+	{
+		RenderQueue        Queue;
+		Vector<TexturePtr> Textures;  // of the queue, alive until it is drawn
+		u32                Stamp;     // of the textures in Textures
+		Vector<StaticDraw> StaticBatches;
+		Vector<TexturePtr> StaticTextures;
+		Vector<QuadVertex> StaticChanges;  // vertices to upload before the draws
+		Transform          ViewProjection;
+		FramebufferPtr     Target;       // null is the window
+		bool               ClearTarget;  // to blank first, for cached layers
+		bool               Clear;        // with the clear color first, see Clear
+
+		bool IsEmpty() const
+		{
+			return Queue.IsEmpty() && !ClearTarget && !Clear;
+		}
+	};
+
+	// Everything from one DrawEnd to the next. With a render thread two frames take
+	// turns, one is recorded while the thread draws the other.
+	struct RenderFrame
+	{
+		Vector<UniquePtr<RenderPass>> Passes;  // kept allocated, PassCount in use
+		u32                           PassCount {0};
+		FrameStats                    Stats {};
+		u64                           Ticket {0};  // render thread job drawing it
+		bool                          Skipped {false};  // begun before shaders ready
+	};
+
+	RenderPass& OpenPass(const Transform& view_projection, FramebufferPtr target);
+	void        ResetFrame(RenderFrame& frame);
+	void        RecordStats(const FrameStats& stats);
+	// The frame of the render thread, in order: BeginFrame, DrawPasses, EndFrame
+	void DrawFrame(RenderFrame& frame);
+	void BeginFrame();
+	void DrawPasses();
+	void EndFrame();
+	void FlushPass(RenderPass& pass);
+	void UploadStaticChanges(const RenderPass& pass);
+	void BindFrameUniforms(const RenderPass& pass);
+	bool AreShadersReady();
+
+	u64  MakeKey(PrimitiveType type, Texture* texture);
+	u16  GetDepthKey() const;
+	u32  GetRenderID(Texture* texture);
+	void HoldTexture(const TexturePtr& texture);
+	void SubmitSprite(const SpriteInstance& sprite, float c, float s, u16 depth);
+	void SubmitQuad(const TexturePtr& texture,
+	                const Transform&  model,
+	                vec2              uvmin,
+	                vec2              uvmax,
+	                u32               array_layer = 0);
+	enum class FlushReason
+	{
+		Texture,
+		Capacity,
+		State,
+		Queue
+	};
+
+	void FlushBatch(FlushReason reason);
+	void CreateBuffers();
+	bool ContinueBatch(const VertexBufferPtr&      vb,
+	                   Vector<DrawIndexedCommand>& draws,
+	                   u32&                        count);
+	void SubmitBatch(const VertexArrayPtr&       va,
+	                 const VertexBufferPtr&      vb,
+	                 Vector<DrawIndexedCommand>& draws,
+	                 u32                         count);
+	void RecordBatch(const VertexBufferPtr&      vb,
+	                 Vector<DrawIndexedCommand>& draws,
+	                 u32                         count);
+	void MapQuadBuffer();
+	void MapShapeBuffer();
+	void ResetTextureSlots();
+	void ApplyBlendMode(BlendMode mode);
+	void EmitQuad(const RenderCommand& command);
+	void EmitShape(const RenderCommand& command);
+	void EmitStaticBatch(const StaticDraw& draw, const RenderPass& pass);
+
+	struct BatchCapacity;
+
+	bool               AdaptCapacity(BatchCapacity& capacity);
+	DrawIndexedCommand MakeDraw(u32 count, u32 base) const;
+	u32                GetRecordCount(u32 count) const;
+	RenderCommand&     PushShape(ShapeType        shape,
+	                             const Transform& model,
+	                             float            thickness,
+	                             float            smoothness = 0.0f);
 
 private:
 	RenderDevice& mDevice;
 
 	Color      mColor;
+	u8         mLayer;
+	float      mDepth;
+	BlendMode  mBlendMode;
 	FrameStats mStats;
 
-	const u32 mMaxQuads;
-	const u32 mMaxVertices;
-	const u32 mMaxIndices;
+	Vector<FrameStats> mHistory;       // ring of the last frames
+	u32                mHistoryIndex;  // next to write
+	u32                mHistoryCount;
+	const bool         mTimeSubmission;
+
+	UniquePtr<GPUProfiler> mProfiler;
+
+	RenderThread* mThread;
+	RenderFrame   mFrames[2];
+	RenderFrame*  mFrame;         // being recorded
+	RenderFrame*  mDrawnFrame;    // being drawn, the same without a render thread
+	RenderPass*   mPass;          // of mFrame, draws go there
+	PrimitiveType mBatchType;     // primitive type of the pending batch
+	BlendMode     mAppliedBlend;  // blend mode currently set on the device
+	CachedLayer*  mCachedLayer;   // being rendered, if any
+	Transform     mFrameViewProjection;
+
+	const BatchMode mMode;
+	const bool      mMultiDraw;
+	const bool      mCompact;  // compact vertex layouts
+
+	// primitives per batch of a primitive type, adapted to the load of the last
+	// frames, see RendererSettings
+	struct BatchCapacity
+	{
+		u32 Size;
+		u32 Used;         // primitives this frame
+		u32 QuietFrames;  // frames in a row using under a quarter of Size
+	};
+
+	const u32     mMinCapacity;
+	const u32     mMaxCapacity;
+	const u32     mShrinkFrames;
+	BatchCapacity mQuadCapacity;
+	BatchCapacity mShapeCapacity;
+
+	// batches continued in the next stream region, drawn with the pending one
+	IndirectBufferPtr          mIndirectBuffer;
+	DrawIndexedCommand*        mIndirectCommands;  // mapped region
+	u32                        mIndirectCount;     // commands used in the region
+	Vector<DrawIndexedCommand> mQuadDraws;
+	Vector<DrawIndexedCommand> mShapeDraws;
 
-	IndexBufferPtr     mIB;
-	Vector<TexturePtr> mTextures;
-	u32                mTextureIndex;
-	TexturePtr         mWhiteTexture;
-	Transform          mViewProjection;
+	IndexBufferPtr mIB;
+	const u32      mArraySlotCount;
+	const u32      mTextureSlotCount;
+	TextureSlots   mTextureSlots;  // of the current batch
+	u32            mTextureCount;  // render ids handed out so far
+	TexturePtr     mWhiteTexture;
 
+	// a record per pass, bound for every shader at once
+	UniformBufferPtr mFrameUniforms;
+	u8*              mFrameRecords;  // mapped region
+	u32              mFrameRecord;   // records used in the region
+	float            mFrameTime;
+	Timer            mClock;
+
+	// vertices (or instances, depending on mMode) are written straight into the
+	// mapped region of the stream buffers
 	VertexBufferPtr    mQuadVB;
 	VertexArrayPtr     mQuadVA;
-	Vector<QuadVertex> mQuadVertices;
+	QuadVertex*        mQuadVertices;
+	QuadVertexCompact* mQuadCompactVertices;
+	QuadInstance*      mQuadInstances;
 	ShaderPtr          mQuadShader;
 	u32                mQuadCount;
+	u32                mQuadRoom;  // primitives left in the mapped region
+
+	VertexBufferPtr     mShapeVB;
+	VertexArrayPtr      mShapeVA;
+	ShapeVertex*        mShapeVertices;
+	ShapeVertexCompact* mShapeCompactVertices;
+	ShapeInstance*      mShapeInstances;
+	ShaderPtr           mShapeShader;
+	u32                 mShapeCount;
+	u32                 mShapeRoom;
 
-	VertexBufferPtr      mCircleVB;
-	VertexArrayPtr       mCircleVA;
-	Vector<CircleVertex> mCircleVertices;
-	ShaderPtr            mCircleShader;
-	u32                  mCircleCount;
+	// vertex layout quad shader, static batches use it in every BatchMode
+	ShaderPtr mStaticShader;
+	bool      mShadersReady;  // stays set once they are
 
 	const vec2 mQuadPositions[4] = {
 	        {-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
 
-	const vec2 mCirclePositions[4] = {
-	        {-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
-
 	const vec2 mTextureUV[4] = {
 	        {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
 };
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <Common.hpp>
+#include <Renderer.hpp>
+#include <SpatialGrid.hpp>
+#include <StaticBatch.hpp>
 #include <Vector2.hpp>
 
 class Entity;
 class Application;
+struct TransformComponent;
+struct SpriteRendererComponent;
 
 class Scene
 {
@@ -34,8 +39,40 @@ public:
 	void Render(double alpha);
 	void Resize(vec2ui resolution);
 
+	// Re-inserts entity into the culling grid before the next render, for
+	// components changed in place instead of through the registry
+	void MarkMoved(entt::entity entity);
+
+private:
+	// Renderable entities are kept in a spatial grid for culling. Only entities
+	// whose transform or renderer component changed through the registry
+	// (patch, replace, emplace, destroy) are re-inserted.
+	void OnBoundsChanged(RegistryType& registry, entt::entity entity);
+	void UpdateBounds();
+
+	// Sprites with a StaticComponent live in static batches instead of the grid
+	void UpdateStatic(u32                            id,
+	                  const TransformComponent&      transform,
+	                  const SpriteRendererComponent& sprite);
+	void RemoveStatic(u32 id);
+
 private:
 	String       mName;
 	Application* mApp;
 	RegistryType mRegistry;
+
+	SpatialGrid          mGrid;
+	Vector<entt::entity> mMoved;    // entities to re-insert before the next render
+	Vector<u32>          mVisible;  // per frame scratch for Render
+
+	Vector<SpriteInstance> mSprites;  // per frame scratch for Render
+
+	struct StaticHandle
+	{
+		u32 Batch;
+		u32 Sprite;
+	};
+
+	Vector<UniquePtr<StaticBatch>> mStaticBatches;
+	HashMap<u32, StaticHandle>     mStaticSprites;
 };
@@ -2,10 +2,34 @@
 
 #include <Color.hpp>
 #include <Common.hpp>
+#include <ShaderSource.hpp>
 #include <Transform.hpp>
 
 using ShaderPtr = SharedPtr<class Shader>;
 
+struct ShaderDesc
+{
+	Path                   File;
+	StringArray            Defines;  // see ShaderSource
+	Vector<ShaderConstant> Constants;
+};
+
+// Location of a uniform, looked up by name once with Shader::GetUniform. Only
+// meaningful for the shader it came from. Uniforms the shader does not have get
+// an invalid handle, setting one does nothing.
+struct UniformHandle
+{
+	i32 Location {-1};
+
+	bool IsValid() const
+	{
+		return Location >= 0;
+	}
+};
+
+// Uniform blocks every shader shares, see shaders/include/Frame.glsl
+constexpr u32 FrameUniformBinding = 0;
+
 enum class ShaderType
 {
 	Vertex,
@@ -17,18 +41,76 @@ class Shader
 public:
 	virtual ~Shader() = default;
 
-	static ShaderPtr Create(const Path& path);
+	// The variant of the shader file the defines and specialization constants
+	// make, see ShaderSource. It is compiled the first time it is asked for and
+	// shared while it is in use. Returns before the driver is done compiling it,
+	// see IsReady.
+	static ShaderPtr Create(const Path&                   path,
+	                        const StringArray&            defines   = {},
+	                        const Vector<ShaderConstant>& constants = {});
+	// Every shader is submitted before any of them is used, so the driver can
+	// compile them together. In the order of shaders.
+	static Vector<ShaderPtr> Create(const Vector<ShaderDesc>& shaders);
+
+	// Linked programs are stored in directory and loaded from it by shaders created
+	// later, on this or a later launch. Empty compiles everything from source.
+	// Backends without program binaries ignore it.
+	static void SetBinaryCache(const Path& directory);
+	// SPIR-V modules of the shader files, built by tools/ShaderCompiler.cpp. Files
+	// and variants without modules, or an empty directory, compile from GLSL.
+	static void SetModuleDirectory(const Path& directory);
+
+	// False while the driver still compiles the shader in the background, and for
+	// good if it failed to. Any other call waits for it to be done. Drivers that can
+	// not tell without waiting wait here.
+	virtual bool IsReady() const = 0;
+	// False if the shader failed to compile or link, binding it binds no program.
+	// Waits like the other calls.
+	virtual bool IsValid() const = 0;
 
 	virtual void Bind() const   = 0;
 	virtual void Unbind() const = 0;
 
-	virtual void SetDouble(const String& name, double v) const     = 0;
-	virtual void SetFloat(const String& name, float v) const       = 0;
-	virtual void SetInt(const String& name, int v) const           = 0;
-	virtual void SetUInt(const String& name, unsigned int v) const = 0;
-	virtual void SetColor(const String& name, Color color) const   = 0;
-	virtual void SetTransform(const String&    name,
-	                          const Transform& transform) const    = 0;
+	// Waits for the shader like the setters. Resolve handles once, not per use.
+	virtual UniformHandle GetUniform(const String& name) const = 0;
+
+	virtual void SetDouble(UniformHandle uniform, double v) const     = 0;
+	virtual void SetFloat(UniformHandle uniform, float v) const       = 0;
+	virtual void SetInt(UniformHandle uniform, int v) const           = 0;
+	virtual void SetUInt(UniformHandle uniform, unsigned int v) const = 0;
+	virtual void SetColor(UniformHandle uniform, Color color) const   = 0;
+	virtual void SetTransform(UniformHandle    uniform,
+	                          const Transform& transform) const       = 0;
+
+	// By name, looked up on every call
+	void SetDouble(const String& name, double v) const
+	{
+		SetDouble(GetUniform(name), v);
+	}
+	void SetFloat(const String& name, float v) const
+	{
+		SetFloat(GetUniform(name), v);
+	}
+	void SetInt(const String& name, int v) const
+	{
+		SetInt(GetUniform(name), v);
+	}
+	void SetUInt(const String& name, unsigned int v) const
+	{
+		SetUInt(GetUniform(name), v);
+	}
+	void SetColor(const String& name, Color color) const
+	{
+		SetColor(GetUniform(name), color);
+	}
+	void SetTransform(const String& name, const Transform& transform) const
+	{
+		SetTransform(GetUniform(name), transform);
+	}
 
 	virtual u32 GetID() const = 0;
+
+protected:
+	static Path sBinaryCache;
+	static Path sModuleDirectory;
 };
@@ -1,34 +1,78 @@
 #pragma once
 
 #include <Shader.hpp>
+#include <ShaderSource.hpp>
 
+// The program links in the background with KHR_parallel_shader_compile. Its
+// results are read, and it is stored in the binary cache, on first use.
 class ShaderGL final: public Shader
 {
 public:
-	explicit ShaderGL(const Path& shaderfile);
+	explicit ShaderGL(const ShaderSource& source);
 	~ShaderGL() override;
 
+	// Set by the device when the driver compiles in the background
+	static void EnableParallelCompile(bool enable);
+
+	bool IsReady() const override;
+	bool IsValid() const override;
+
 	void Bind() const override;
 	void Unbind() const override;
 
-	void SetDouble(const String& name, double v) const override;
-	void SetFloat(const String& name, float v) const override;
-	void SetInt(const String& name, int v) const override;
-	void SetUInt(const String& name, unsigned int v) const override;
-	void SetColor(const String& name, Color color) const override;
-	void SetTransform(const String& name, const Transform& transform) const override;
+	UniformHandle GetUniform(const String& name) const override;
+
+	// the by name setters of Shader
+	using Shader::SetColor;
+	using Shader::SetDouble;
+	using Shader::SetFloat;
+	using Shader::SetInt;
+	using Shader::SetTransform;
+	using Shader::SetUInt;
+
+	void SetDouble(UniformHandle uniform, double v) const override;
+	void SetFloat(UniformHandle uniform, float v) const override;
+	void SetInt(UniformHandle uniform, int v) const override;
+	void SetUInt(UniformHandle uniform, unsigned int v) const override;
+	void SetColor(UniformHandle uniform, Color color) const override;
+	void SetTransform(UniformHandle    uniform,
+	                  const Transform& transform) const override;
 
 	u32 GetID() const override;
 
 private:
-	static void ReadFile(const Path& shaderfile, String& source);
-	static void Preprocess(const String& source, String& vsout, String& fsout);
-	void        Compile(const String& vsource, const String& fsource);
-	void        Postprocess();
+	void Compile(const String& vsource, const String& fsource);
+	bool LoadModules(const ShaderSource& source);
+	void LinkProgram(GLuint vsid, GLuint fsid);
+	void Finish() const;  // waits for the link once
+	void Link() const;
+	void Postprocess() const;
+
+	// 0 if the module is missing or the driver rejects it
+	static GLuint LoadModule(GLenum              type,
+	                         const Path&         path,
+	                         const ShaderSource& source);
+
+	// The program binary depends on the preprocessed source and the driver
+	static u64  MakeBinaryKey(const String& vsource, const String& fsource);
+	static Path GetBinaryPath(u64 key);
+	bool        LoadBinary(u64 key);
+	void        SaveBinary(u64 key) const;
 
 	static GLenum ShaderTypeMap(ShaderType type);
 
 private:
-	u32                    mProgramID;
-	HashMap<String, GLint> mUniformLocations;
+	static bool sParallelCompile;
+
+	u32         mProgramID;
+	String      mName;  // file name, for the log
+	u64         mBinaryKey;
+	bool        mCached;  // loaded from the binary cache
+	const char* mOrigin;  // how the program was built, for the log
+	double      mSubmitTime;
+
+	mutable std::once_flag         mLinked;
+	mutable std::atomic<bool>      mReady;
+	mutable std::atomic<bool>      mFailed;
+	mutable HashMap<String, GLint> mUniformLocations;
 };
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Shader.hpp>
+
+// Neither reads nor compiles the source, uniforms are ignored
+class ShaderNull final: public Shader
+{
+public:
+	explicit ShaderNull(const Path& shaderfile);
+
+	bool IsReady() const override;
+	bool IsValid() const override;
+
+	void Bind() const override;
+	void Unbind() const override;
+
+	UniformHandle GetUniform(const String& name) const override;
+
+	// the by name setters of Shader
+	using Shader::SetColor;
+	using Shader::SetDouble;
+	using Shader::SetFloat;
+	using Shader::SetInt;
+	using Shader::SetTransform;
+	using Shader::SetUInt;
+
+	void SetDouble(UniformHandle uniform, double v) const override;
+	void SetFloat(UniformHandle uniform, float v) const override;
+	void SetInt(UniformHandle uniform, int v) const override;
+	void SetUInt(UniformHandle uniform, unsigned int v) const override;
+	void SetColor(UniformHandle uniform, Color color) const override;
+	void SetTransform(UniformHandle    uniform,
+	                  const Transform& transform) const override;
+
+	u32 GetID() const override;
+
+private:
+	u32 mID;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <Common.hpp>
+
+// Value of the specialization constant declared with layout(constant_id = ID), the
+// bit pattern of a bool, int, uint or float
+struct ShaderConstant
+{
+	u32 ID;
+	u32 Value;
+};
+
+// Starts the .spv files of tools/ShaderCompiler.cpp, the SPIR-V words follow.
+// Hash is the ShaderSource::GetHash of the variant the module was compiled from.
+struct ShaderModuleHeader
+{
+	u32 Magic;  // ShaderModuleMagic
+	u32 Reserved;
+	u64 Hash;
+};
+
+static constexpr u32 ShaderModuleMagic = 0x314d5345;  // "ESM1"
+
+enum class ShaderTarget
+{
+	GLSL,  // compiled by the driver
+	SPIRV  // compiled ahead of time, see tools/ShaderCompiler.cpp
+};
+
+// Vertex and fragment source of a shader file, built in one pass over its lines.
+// - "#type vertex" and "#type fragment" start the source of a stage
+// - #include "file" pastes file, relative to the file including it. A file is
+//   pasted once per stage, later includes of it are dropped like with a guard.
+// - each define, NAME or NAME=VALUE, is declared right after a stage's #version
+// - layout(constant_id = N) declarations stay for SPIR-V. For GLSL they become
+//   plain constants with the value given for N, or the default of the source.
+// - layout(location = N) uniforms are remembered, SPIR-V programs have no names
+//   to look them up by
+// Files are read from disk once and kept for every later variant.
+class ShaderSource
+{
+public:
+	ShaderSource(const Path&                   path,
+	             const StringArray&            defines,
+	             const Vector<ShaderConstant>& constants,
+	             ShaderTarget                  target = ShaderTarget::GLSL);
+
+	const Path& GetPath() const
+	{
+		return mPath;
+	}
+	const String& GetVertex() const
+	{
+		return mVertex;
+	}
+	const String& GetFragment() const
+	{
+		return mFragment;
+	}
+	const Vector<ShaderConstant>& GetConstants() const
+	{
+		return mConstants;
+	}
+	const HashMap<String, i32>& GetUniformLocations() const
+	{
+		return mUniformLocations;
+	}
+	// File name of the variant's SPIR-V modules, without the stage extension
+	const String& GetModuleName() const
+	{
+		return mModuleName;
+	}
+	// Of the defines and the lines of the files the variant was read from. The
+	// constants and the target leave it alone, it tells a stale module apart.
+	u64 GetHash() const
+	{
+		return mHash;
+	}
+
+	// Identifies the variant of path, the order of the defines and the constants
+	// does not matter
+	static String MakeKey(const Path&                   path,
+	                      const StringArray&            defines,
+	                      const Vector<ShaderConstant>& constants);
+
+private:
+	void Append(const Path& path, bool included);
+	void AppendConstant(std::string_view declaration, u32 id);
+
+	static const String* ReadFile(const Path& path);
+
+private:
+	Path                   mPath;
+	Vector<ShaderConstant> mConstants;
+	ShaderTarget           mTarget;
+	String                 mDefines;  // the #define lines
+	String                 mModuleName;
+	u64                    mHash;
+
+	String               mVertex;
+	String               mFragment;
+	HashMap<String, i32> mUniformLocations;
+
+	String*          mStage;     // where lines go, null before the first #type
+	std::set<String> mIncluded;  // files pasted into the current stage
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Common.hpp>
+#include <Vector2.hpp>
+
+struct AABB
+{
+	vec2 Min;
+	vec2 Max;
+
+	bool Overlaps(const AABB& r) const
+	{
+		return Min.x <= r.Max.x && Max.x >= r.Min.x && Min.y <= r.Max.y &&
+		       Max.y >= r.Min.y;
+	}
+};
+
+// Loose uniform grid. Items live in the single cell that holds their center, and
+// queries are widened by the largest half extent in the grid. Moving an item
+// within its cell only updates its bounds.
+class SpatialGrid
+{
+public:
+	explicit SpatialGrid(float cell_size = 512.0f);
+	SpatialGrid(const SpatialGrid&)            = delete;
+	SpatialGrid& operator=(const SpatialGrid&) = delete;
+
+	// Inserts id, or moves it if it is already in the grid
+	void Update(u32 id, const AABB& bounds);
+	void Remove(u32 id);
+	void Clear();
+	// Lowers the query margin after the largest item shrank or was removed, a
+	// pass over all items when it did. Call it after a round of updates.
+	void Refit();
+
+	// Appends the ids whose bounds overlap area
+	void Query(const AABB& area, Vector<u32>& result) const;
+
+	u32 GetSize() const
+	{
+		return u32(mItems.size());
+	}
+
+private:
+	struct Entry
+	{
+		AABB Bounds;
+		u32  ID;
+	};
+
+	struct Item
+	{
+		u64 Cell;
+		u32 Slot;  // index in the cell's entries
+	};
+
+	u64  GetCell(vec2 point) const;
+	void Unlink(const Item& item);
+	void Release(const AABB& bounds, vec2 replacement);
+
+private:
+	float mCellSize;
+	vec2  mMaxHalfExtent;
+	bool  mRefit;  // an item as large as mMaxHalfExtent shrank or left
+
+	HashMap<u64, Vector<Entry>> mCells;
+	HashMap<u32, Item>          mItems;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Color.hpp>
+#include <Common.hpp>
+#include <GPUBuffers.hpp>
+#include <Renderer.hpp>
+#include <Texture.hpp>
+#include <Transform.hpp>
+
+// Sprites that rarely change, e.g. backgrounds and level geometry. Their vertices
+// stay in a GPU buffer between frames and changing a sprite only re-uploads the
+// range of quads modified since the last upload. The whole batch is a single
+// draw call, see Renderer::DrawStaticBatch.
+class StaticBatch
+{
+public:
+	// Takes the texture slot counts of renderer, the one drawing it
+	StaticBatch(const Renderer& renderer, u8 layer, u32 capacity = 1024);
+	StaticBatch(const StaticBatch&)            = delete;
+	StaticBatch& operator=(const StaticBatch&) = delete;
+
+	// False if all texture slots of the batch are taken by other textures. A slot
+	// is free again once no sprite uses its texture.
+	bool CanAdd(const Texture* texture) const;
+
+	// Returns the handle used by Update and Remove
+	u32  Add(const SubTexture& sprite, const Transform& model, Color color);
+	void Update(u32               handle,
+	            const SubTexture& sprite,
+	            const Transform&  model,
+	            Color             color);
+	void Remove(u32 handle);
+
+	// Appends the vertices of the quads changed since the last call to vertices
+	// and returns the index of the first one in the vertex buffer. Renderer
+	// uploads them when it draws the batch, on its render thread if it has one.
+	u32 TakeChanges(Vector<QuadVertex>& vertices);
+
+	u8 GetLayer() const
+	{
+		return mLayer;
+	}
+
+	// Quads to draw, removed sprites leave degenerate quads behind until reused
+	u32 GetQuadCount() const
+	{
+		return mQuadCount;
+	}
+
+	u32 GetSpriteCount() const
+	{
+		return mQuadCount - u32(mFree.size());
+	}
+
+	// Slot i holds the texture bound to unit i, may be null
+	const Vector<TexturePtr>& GetTextures() const
+	{
+		return mSlots;
+	}
+
+	const VertexArrayPtr& GetVertexArray() const
+	{
+		return mVA;
+	}
+
+	const VertexBufferPtr& GetVertexBuffer() const
+	{
+		return mVB;
+	}
+
+private:
+	u32  FindSlot(const Texture* texture) const;
+	u32  FindFreeSlot(const Texture* texture) const;
+	u32  GetSlot(const TexturePtr& texture);
+	void ReleaseSlot(u32 slot);
+	void Write(u32               quad,
+	           const SubTexture& sprite,
+	           const Transform&  model,
+	           Color             color);
+	void Grow(u32 capacity);
+
+private:
+	u8  mLayer;
+	u32 mCapacity;
+	u32 mQuadCount;
+	u32 mDirtyBegin;  // changed quads [begin, end)
+	u32 mDirtyEnd;
+
+	Vector<QuadVertex> mVertices;
+	Vector<u32>        mFree;  // removed quads
+
+	Vector<TexturePtr> mSlots;
+	Vector<u32>        mSlotUses;      // sprites per slot
+	u32                mTextureSlots;  // the array slots follow
+
+	VertexBufferPtr mVB;
+	IndexBufferPtr  mIB;
+	VertexArrayPtr  mVA;
+};
@@ -14,6 +14,15 @@ enum class WrapMode
 	Clamp
 };
 
+// Storage of textures created empty, e.g. framebuffer attachments
+enum class TextureFormat
+{
+	RGBA8,
+	RGB10A2,
+	RGBA16F,  // HDR
+	R8
+};
+
 class Texture
 {
 public:
@@ -26,6 +35,22 @@ public:
 	                         bool     filter = false,
 	                         WrapMode wrap   = WrapMode::Repeat,
 	                         Color    border = Color::WHITE);
+	static TexturePtr Create(u32           width,
+	                         u32           height,
+	                         TextureFormat format,
+	                         bool          filter = false,
+	                         WrapMode      wrap   = WrapMode::Clamp);
+
+	// Array textures hold equally sized layers behind a single binding, the
+	// renderer picks the layer per sprite instead of using a texture slot.
+	static TexturePtr CreateArray(u32      width,
+	                              u32      height,
+	                              u32      layers,
+	                              bool     filter = false,
+	                              WrapMode wrap   = WrapMode::Clamp,
+	                              Color    border = Color::WHITE);
+	// One layer per frame of the sheet, left to right and top to bottom
+	static TexturePtr CreateArray(const Path& path, u32 frame_width, u32 frame_height);
 
 	virtual void Bind(u32 slot) const = 0;
 
@@ -35,6 +60,9 @@ public:
 	virtual u32    GetWidth() const      = 0;
 	virtual u32    GetHeight() const     = 0;
 
+	virtual bool IsArray() const       = 0;
+	virtual u32  GetLayerCount() const = 0;  // 1 for non-array textures
+
 	virtual bool IsFiltered() const     = 0;
 	virtual void SetFilter(bool enable) = 0;
 
@@ -42,9 +70,43 @@ public:
 	virtual void     SetWrapMode(WrapMode wrap, Color border = Color::WHITE) = 0;
 
 	virtual void SetData(const void* data, size_t size) = 0;
+	// Uploads a width x height block of pixels at (x, y), same format as SetData
+	virtual void SetSubData(const void* data, u32 x, u32 y, u32 width, u32 height) = 0;
+	// Uploads a whole layer of an array texture
+	virtual void SetLayerData(const void* data, u32 layer) = 0;
+	// Zeroes every texel, transparent black, without uploading anything
+	virtual void Clear() = 0;
 
 	virtual u32 GetID() const = 0;
 
 	bool operator==(const Texture& rhs) const;
 	bool operator!=(const Texture& rhs) const;
+
+private:
+	friend class Renderer;
+	friend class TextureSlots;
+
+	// Renderer bookkeeping: a compact id assigned on first draw, the texture slot
+	// this texture got in the batch identified by mBatchStamp, and the last pass
+	// that holds a reference to it.
+	u32 mRenderID {0};
+	u32 mBatchStamp {0};
+	u32 mBatchSlot {0};
+	u32 mPassStamp {0};
+};
+
+// A region of a texture, e.g. an entry of a TextureAtlas page
+struct SubTexture
+{
+	SubTexture() = default;
+	explicit SubTexture(const TexturePtr& texture);
+	SubTexture(const TexturePtr& texture, vec2 uvmin, vec2 uvmax, vec2ui resolution);
+	// A whole layer of an array texture
+	SubTexture(const TexturePtr& texture, u32 layer);
+
+	TexturePtr Texture;
+	vec2       UVMin {0.0f};
+	vec2       UVMax {1.0f};
+	vec2ui     Resolution;  // size of the region in pixels
+	u32        ArrayLayer {0};
 };
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Common.hpp>
+#include <RenderDevice.hpp>
+#include <Texture.hpp>
+#include <Vector2.hpp>
+
+// Packs images into a few large RGBA8 pages with a skyline bottom-left packer, so
+// sprites from different images can share a texture slot and a batch.
+// Each image is surrounded by `extrude` pixels repeating its border (against
+// bleeding when filtering) and `padding` empty pixels.
+class TextureAtlas
+{
+public:
+	explicit TextureAtlas(const RenderDevice& device,
+	                      u32                 page_size = 2048,
+	                      u32                 padding   = 1,
+	                      u32                 extrude   = 1,
+	                      bool                filter    = false);
+	TextureAtlas(const TextureAtlas&)            = delete;
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+	SubTexture Add(const Path& path);
+	// RGBA8 pixels, rows from top to bottom
+	SubTexture Add(const u8* pixels, u32 width, u32 height);
+	// Packs tallest images first which fills the pages noticeably better than
+	// adding them one by one. Results are in the order of paths.
+	Vector<SubTexture> Add(const Vector<Path>& paths);
+
+	const Vector<TexturePtr>& GetPages() const
+	{
+		return mPageTextures;
+	}
+
+	u32 GetPageSize() const
+	{
+		return mPageSize;
+	}
+
+private:
+	struct SkylineNode
+	{
+		u32 X;
+		u32 Y;
+		u32 Width;
+	};
+
+	using Skyline = Vector<SkylineNode>;
+
+	bool Fit(const Skyline& skyline, u32 index, u32 width, u32 height, u32& y) const;
+	bool Insert(Skyline& skyline, u32 width, u32 height, vec2ui& position);
+	void AddPage();
+
+private:
+	u32  mPageSize;
+	u32  mPadding;
+	u32  mExtrude;
+	bool mFilter;
+
+	Vector<TexturePtr> mPageTextures;
+	Vector<Skyline>    mPageSkylines;
+	Vector<u8>         mCell;  // scratch image with extruded borders
+};
@@ -13,6 +13,18 @@ public:
 	          bool     filter = false,
 	          WrapMode wrap   = WrapMode::Repeat,
 	          Color    border = Color::WHITE);
+	TextureGL(u32           width,
+	          u32           height,
+	          TextureFormat format,
+	          bool          filter = false,
+	          WrapMode      wrap   = WrapMode::Clamp);
+	TextureGL(u32      width,
+	          u32      height,
+	          u32      layers,
+	          bool     filter = false,
+	          WrapMode wrap   = WrapMode::Clamp,
+	          Color    border = Color::WHITE);
+	TextureGL(const Path& path, u32 frame_width, u32 frame_height);
 	~TextureGL() override;
 
 	void Bind(u32 slot) const override;
@@ -23,6 +35,9 @@ public:
 	u32    GetWidth() const override;
 	u32    GetHeight() const override;
 
+	bool IsArray() const override;
+	u32  GetLayerCount() const override;
+
 	bool IsFiltered() const override;
 	void SetFilter(bool enable) override;
 
@@ -30,6 +45,9 @@ public:
 	void     SetWrapMode(WrapMode wrap, Color border = Color::WHITE) override;
 
 	void SetData(const void* data, size_t size) override;
+	void SetSubData(const void* data, u32 x, u32 y, u32 width, u32 height) override;
+	void SetLayerData(const void* data, u32 layer) override;
+	void Clear() override;
 
 	u32 GetID() const override;
 
@@ -37,9 +55,12 @@ private:
 	u32      mID {0};
 	u32      mWidth {1};
 	u32      mHeight {1};
+	u32      mLayers {1};
+	bool     mArray {false};
 	bool     mFiltered {false};
 	WrapMode mWrapMode {WrapMode::Repeat};
 	Color    mBorder {Color::WHITE};
 	u32      mDataFormat {0};
 	u32      mInternalFormat {0};
+	u32      mDataType {GL_UNSIGNED_BYTE};  // of SetData and friends
 };
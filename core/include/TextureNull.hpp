@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Common.hpp>
+#include <Texture.hpp>
+
+// Keeps the size and sampling state only, images are never decoded
+class TextureNull final: public Texture
+{
+public:
+	TextureNull();
+	explicit TextureNull(const Path& path);
+	TextureNull(u32      width,
+	            u32      height,
+	            bool     filter = false,
+	            WrapMode wrap   = WrapMode::Repeat,
+	            Color    border = Color::WHITE);
+	TextureNull(u32           width,
+	            u32           height,
+	            TextureFormat format,
+	            bool          filter = false,
+	            WrapMode      wrap   = WrapMode::Clamp);
+	TextureNull(u32      width,
+	            u32      height,
+	            u32      layers,
+	            bool     filter = false,
+	            WrapMode wrap   = WrapMode::Clamp,
+	            Color    border = Color::WHITE);
+	TextureNull(const Path& path, u32 frame_width, u32 frame_height);
+
+	void Bind(u32 slot) const override;
+
+	size_t GetSize() const override;
+
+	vec2ui GetResolution() const override;
+	u32    GetWidth() const override;
+	u32    GetHeight() const override;
+
+	bool IsArray() const override;
+	u32  GetLayerCount() const override;
+
+	bool IsFiltered() const override;
+	void SetFilter(bool enable) override;
+
+	WrapMode GetWrapMode() const override;
+	void     SetWrapMode(WrapMode wrap, Color border = Color::WHITE) override;
+
+	void SetData(const void* data, size_t size) override;
+	void SetSubData(const void* data, u32 x, u32 y, u32 width, u32 height) override;
+	void SetLayerData(const void* data, u32 layer) override;
+	void Clear() override;
+
+	u32 GetID() const override;
+
+private:
+	u32      mID;
+	u32      mWidth {1};
+	u32      mHeight {1};
+	u32      mLayers {1};
+	u32      mPixelSize {4};  // bytes
+	bool     mArray {false};
+	bool     mFiltered {false};
+	WrapMode mWrapMode {WrapMode::Repeat};
+};
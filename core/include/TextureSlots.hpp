@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Common.hpp>
+#include <Texture.hpp>
+
+// The texture units a batch samples from, 2D textures in the first slots and
+// array textures in the ones after them. A texture remembers the slot it got
+// along with the stamp of the assignment, so finding it is a single compare and
+// Reset frees every slot at once. Stamps are unique among all instances, a
+// texture drawn by several renderers never finds a slot another one gave it.
+class TextureSlots
+{
+public:
+	TextureSlots(u32 textures, u32 arrays);
+	TextureSlots(const TextureSlots&)            = delete;
+	TextureSlots& operator=(const TextureSlots&) = delete;
+
+	// Slot of texture, given one if it has none yet. False if the slots of its
+	// kind are taken, draw the batch and Reset.
+	bool Acquire(Texture* texture, u32& slot);
+	void Reset();
+	// True once the 2D or the array slots are all taken
+	bool IsFull() const;
+
+	// Binds the textures to the units of their slots, returns how many
+	u32 Bind() const;
+
+private:
+	static std::atomic<u32> sStamp;
+
+	Vector<Texture*> mSlots;
+	u32              mTextureSlots;  // the array slots follow
+	u32              mTextureIndex;  // first free 2D slot
+	u32              mArrayIndex;    // first free array slot
+	u32              mStamp;
+};
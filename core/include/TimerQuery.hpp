@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Common.hpp>
+
+using TimerQueryPtr = SharedPtr<class TimerQuery>;
+
+// Reads the GPU clock in nanoseconds. Results arrive once the GPU has executed
+// the commands before the query, poll IsAvailable instead of waiting for them.
+class TimerQuery
+{
+public:
+	virtual ~TimerQuery() = default;
+
+	static TimerQueryPtr Create();
+
+	// Measures the GPU time of the commands between Begin and End. Only one
+	// query can measure at a time.
+	virtual void Begin() = 0;
+	virtual void End()   = 0;
+	// Records the GPU time at which the commands issued so far are done
+	virtual void Timestamp() = 0;
+
+	// False until issued and executed, reading the result then would stall
+	virtual bool IsAvailable() const = 0;
+	virtual u64  GetResult() const   = 0;
+};
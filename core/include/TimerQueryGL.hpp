@@ -0,0 +1,21 @@
+#pragma once
+
+#include <TimerQuery.hpp>
+
+class TimerQueryGL final: public TimerQuery
+{
+public:
+	TimerQueryGL();
+	~TimerQueryGL() override;
+
+	void Begin() override;
+	void End() override;
+	void Timestamp() override;
+
+	bool IsAvailable() const override;
+	u64  GetResult() const override;
+
+private:
+	u32  mID {0};
+	bool mIssued {false};  // availability of a query never issued is an error
+};
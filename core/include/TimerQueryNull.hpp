@@ -0,0 +1,18 @@
+#pragma once
+
+#include <TimerQuery.hpp>
+
+// Available as soon as issued, every result is 0
+class TimerQueryNull final: public TimerQuery
+{
+public:
+	void Begin() override;
+	void End() override;
+	void Timestamp() override;
+
+	bool IsAvailable() const override;
+	u64  GetResult() const override;
+
+private:
+	bool mIssued {false};
+};
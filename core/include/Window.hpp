@@ -49,6 +49,9 @@ public:
 	bool       Borderless {false};
 	bool       Focused {true};
 	bool       Hidden {false};
+	// No window, rendering goes to an offscreen back buffer. Needs a build with
+	// ENGINE_HEADLESS (EGL), also selected by the --headless argument.
+	bool Headless {false};
 };
 
 class Window
@@ -65,6 +68,8 @@ public:
 	Signal<vec2>                     ScrollSignal;
 
 public:
+	using ProcAddress = void (*)();
+
 	explicit Window(WindowSettings settings);
 	Window(const Window&)            = delete;
 	Window& operator=(const Window&) = delete;
@@ -114,7 +119,21 @@ public:
 	virtual bool IsHidden() const       = 0;
 	virtual void SetHidden(bool hidden) = 0;
 
+	bool IsHeadless() const
+	{
+		return mSettings.Headless;
+	}
+
 	virtual void* GetHandle() const = 0;
+	// Graphics API function of the window's context, used to load OpenGL
+	virtual ProcAddress GetProcAddress(const char* name) const = 0;
+
+	// The context is current on one thread at a time, see RenderThread. A thread
+	// that gives it away can make a context sharing its objects current instead,
+	// created on first use.
+	virtual void MakeContextCurrent()       = 0;
+	virtual void MakeSharedContextCurrent() = 0;
+	virtual void DetachContext()            = 0;
 
 	virtual void SwapBuffers() = 0;
 	virtual void PollEvents()  = 0;
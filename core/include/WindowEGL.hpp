@@ -0,0 +1,32 @@
+#pragma once
+
+#include <WindowNull.hpp>
+
+// No window at all, an EGL context without a surface (or with a pbuffer where
+// surfaceless contexts are missing). The render device draws into an offscreen
+// back buffer instead, see RenderDevice::GetBackBuffer. Made for benchmarks on
+// machines without a display, Mesa llvmpipe is enough.
+class WindowEGL final: public WindowNull
+{
+public:
+	explicit WindowEGL(const WindowSettings& settings);
+	~WindowEGL() override;
+
+	void*       GetHandle() const override;
+	ProcAddress GetProcAddress(const char* name) const override;
+
+	void MakeContextCurrent() override;
+	void MakeSharedContextCurrent() override;
+	void DetachContext() override;
+
+	void SwapBuffers() override;
+
+private:
+	// EGL handles, kept opaque to not leak EGL headers
+	void* mDisplay {nullptr};
+	void* mConfig {nullptr};
+	void* mContext {nullptr};
+	void* mSurface {nullptr};  // only without EGL_KHR_surfaceless_context
+	void* mSharedContext {nullptr};
+	void* mSharedSurface {nullptr};
+};
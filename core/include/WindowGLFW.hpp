@@ -46,7 +46,12 @@ public:
 	bool IsHidden() const override;
 	void SetHidden(bool hidden) override;
 
-	void* GetHandle() const override;
+	void*       GetHandle() const override;
+	ProcAddress GetProcAddress(const char* name) const override;
+
+	void MakeContextCurrent() override;
+	void MakeSharedContextCurrent() override;
+	void DetachContext() override;
 
 	void SwapBuffers() override;
 	void PollEvents() override;
@@ -63,8 +68,10 @@ public:
 	friend void ScrollCallback(GLFWwindow* win, double xoffset, double yoffset);
 
 private:
-	GLFWwindow* mWindow;
-	static u32  sWindowCount;
+	GLFWwindow*       mWindow;
+	GLFWwindow*       mSharedWindow;  // hidden, for its context only
+	std::atomic<bool> mSwapIntervalPending;
+	static u32        sWindowCount;
 };
 
 void CloseCallback(GLFWwindow* win);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Window.hpp>
+
+// No window and no context, keeps the settings and never receives events. Used
+// with RenderAPI::None, the main loop only ends through Application's frame
+// limit or Terminate.
+class WindowNull: public Window
+{
+public:
+	explicit WindowNull(const WindowSettings& settings);
+
+	const String& GetTitle() const override;
+	void          SetTitle(const String& title) override;
+
+	u32    GetWidth() const override;
+	u32    GetHeight() const override;
+	vec2ui GetResolution() const override;
+	void   SetWidth(u32 width) override;
+	void   SetHeight(u32 height) override;
+	void   SetResolution(vec2ui resolution) override;
+
+	vec2ui GetPosition() const override;
+	void   SetPosition(vec2ui pos) override;
+
+	WindowMode GetWindowMode() const override;
+	bool       IsFullscreen() const override;
+	void       SetWindowMode(WindowMode mode) override;
+
+	VSyncMode GetVSyncMode() const override;
+	void      SetVSyncMode(VSyncMode mode) override;
+
+	u32  GetMSAA() const override;
+	void SetMSAA(u32 samples) override;
+
+	bool IsSRGB() const override;
+	void SetSRGB(bool srgb) override;
+
+	bool IsResizable() const override;
+	void SetResizable(bool resizable) override;
+
+	bool IsBorderless() const override;
+	void SetBorderless(bool borderless) override;
+
+	bool IsFocused() const override;
+	void SetFocus(bool focused) override;
+
+	bool IsHidden() const override;
+	void SetHidden(bool hidden) override;
+
+	void*       GetHandle() const override;
+	ProcAddress GetProcAddress(const char* name) const override;
+
+	void MakeContextCurrent() override;
+	void MakeSharedContextCurrent() override;
+	void DetachContext() override;
+
+	void SwapBuffers() override;
+	void PollEvents() override;
+};
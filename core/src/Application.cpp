@@ -1,10 +1,12 @@
 #include <Application.hpp>
 
+#include <Shader.hpp>
 #include <Timer.hpp>
 
 Application::Application(String name, Path working_dir)
         : mName(std::move(name)),
           mWorkingDir(std::move(working_dir)),
+          mWindowSettings(mName),
           mSceneManager(this)
 {
 	if(!mWorkingDir.empty() && fs::exists(mWorkingDir))
@@ -13,11 +15,38 @@ Application::Application(String name, Path working_dir)
 
 Application::~Application() = default;
 
+void Application::ParseArguments(int argc, char** argv)
+{
+	for(int i = 1; i < argc; ++i)
+	{
+		String arg = argv[i];
+
+		if(arg == "--headless")
+			mWindowSettings.Headless = true;
+		else if(arg == "--null")
+			RenderDevice::SetAPI(RenderAPI::None);
+		else if(arg == "--threaded")
+			mUseRenderThread = true;
+		else if(arg == "--no-shader-cache")
+			mShaderCache.clear();
+		else if(arg == "--no-spirv")
+			mShaderModules.clear();
+		else if(arg.rfind("--frames=", 0) == 0)
+			mFrameLimit = u32(std::strtoul(arg.c_str() + 9, nullptr, 10));
+		else
+			WARN("Unknown argument %s", arg);
+	}
+}
+
 void Application::Run()
 {
-	mWindow       = Window::Create(WindowSettings(mName));
-	mRenderDevice = RenderDevice::Create();
-	mRenderer     = MakeUnique<Renderer>(mRenderDevice, 2048);
+	Timer startup;
+	Shader::SetBinaryCache(mShaderCache);
+	Shader::SetModuleDirectory(mShaderModules);
+
+	mWindow       = Window::Create(mWindowSettings);
+	mRenderDevice = RenderDevice::Create(*mWindow);
+	mRenderer     = MakeUnique<Renderer>(mRenderDevice, mRendererSettings);
 
 	mWindow->CloseSignal.Connect(this, &Application::OnWindowClose);
 	mWindow->FocusSignal.Connect(this, &Application::OnWindowFocus);
@@ -25,9 +54,21 @@ void Application::Run()
 
 	Initialize();
 
+	INFO("Startup took %.1f ms, shader cache %s, SPIR-V %s",
+	     startup.MilliSeconds(),
+	     mShaderCache.empty() ? "disabled" : "enabled",
+	     mShaderModules.empty() ? "disabled" : "enabled");
+
+	if(mUseRenderThread)
+	{
+		mRenderThread = MakeUnique<RenderThread>(*mWindow);
+		mRenderer->SetRenderThread(mRenderThread.get());
+	}
+
 	Timer  timer;
 	u32    fixed_iterations = 0;
 	u32    index            = 0;
+	u32    frames           = 0;
 	double dt_accu          = 0.0;
 
 	while(mRunning)
@@ -61,9 +102,23 @@ void Application::Run()
 			mScene->Render(dt_accu / mFixedDeltaTime);
 		}
 
-		mWindow->SwapBuffers();
+		if(mRenderThread)
+			mRenderThread->Present();
+		else
+			mWindow->SwapBuffers();
+
+		if(mFrameLimit != 0 && ++frames == mFrameLimit)
+			mRunning = false;
 	}
 
+	// OnExit and the destructors get the context back
+	if(mRenderThread)
+	{
+		mRenderer->SetRenderThread(nullptr);
+		mRenderThread.reset();
+	}
+
+	mRenderer->LogStatsSummary();
 	OnExit();
 }
 
@@ -91,8 +146,21 @@ bool Application::OnWindowFocus(bool b)
 
 bool Application::OnFramebuffer(vec2ui resolution)
 {
-	mRenderDevice->UpdateViewport(0, 0, resolution.x, resolution.y);
+	if(mRenderThread)
+	{
+		// OnResize may resize what the queued frames render to
+		mRenderer->Sync();
+		mRenderThread->Submit([this, resolution] { UpdateViewport(resolution); });
+	}
+	else
+		UpdateViewport(resolution);
+
 	mScene->Resize(resolution);
 	OnResize(resolution);
 	return true;
 }
+
+void Application::UpdateViewport(vec2ui resolution)
+{
+	mRenderDevice->UpdateViewport(0, 0, resolution.x, resolution.y);
+}
@@ -0,0 +1,14 @@
+#include <CachedLayer.hpp>
+
+CachedLayer::CachedLayer(u8 layer, u32 width, u32 height, TextureFormat format)
+        : mLayer(layer),
+          mValid(false),
+          mFramebuffer(Framebuffer::Create(width, height, {format}))
+{
+}
+
+void CachedLayer::Resize(u32 width, u32 height)
+{
+	mFramebuffer->Resize(width, height);
+	mValid = false;
+}
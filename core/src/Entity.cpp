@@ -13,6 +13,11 @@ const String& Entity::GetName() const
 	return GetComponent<TagComponent>().Tag;
 }
 
+void Entity::MarkMoved()
+{
+	mScene->MarkMoved(mHandle);
+}
+
 Entity::operator HandleType() const
 {
 	return mHandle;
@@ -0,0 +1,22 @@
+#include <Framebuffer.hpp>
+
+#include <Assert.hpp>
+#include <FramebufferGL.hpp>
+#include <FramebufferNull.hpp>
+#include <RenderDevice.hpp>
+
+FramebufferPtr Framebuffer::Create(u32                          width,
+                                   u32                          height,
+                                   const Vector<TextureFormat>& formats,
+                                   bool                         filter)
+{
+	switch(RenderDevice::GetAPI())
+	{
+	case RenderAPI::None:
+		return MakeShared<FramebufferNull>(width, height, formats, filter);
+	case RenderAPI::GL:
+		return MakeShared<FramebufferGL>(width, height, formats, filter);
+	}
+	ASSERT(false, "Render API not supported");
+	return nullptr;
+}
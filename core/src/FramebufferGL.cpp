@@ -0,0 +1,112 @@
+#include <FramebufferGL.hpp>
+
+#include <Assert.hpp>
+#include <Logger.hpp>
+#include <RenderDeviceGL.hpp>
+
+FramebufferGL::FramebufferGL(u32                          width,
+                             u32                          height,
+                             const Vector<TextureFormat>& formats,
+                             bool                         filter)
+        : mWidth(width),
+          mHeight(height),
+          mFiltered(filter),
+          mFormats(formats)
+{
+	ASSERT(!mFormats.empty(), "Framebuffer without attachments");
+
+	CreateAttachments();
+}
+
+FramebufferGL::~FramebufferGL()
+{
+	RenderDeviceGL::DeleteContainer(
+	        RenderDeviceGL::ContainerType::Framebuffer, mID, mOwner);
+}
+
+void FramebufferGL::Resize(u32 width, u32 height)
+{
+	if(width == mWidth && height == mHeight)
+		return;
+
+	mWidth  = width;
+	mHeight = height;
+	CreateAttachments();
+}
+
+void FramebufferGL::Clear(Color color)
+{
+	float c[4];
+	color.GetColors(c);
+	u32 id = GetID();
+	for(u32 i = 0; i < mAttachments.size(); ++i)
+		glClearNamedFramebufferfv(id, GL_COLOR, GLint(i), c);
+}
+
+vec2ui FramebufferGL::GetResolution() const
+{
+	return {mWidth, mHeight};
+}
+
+u32 FramebufferGL::GetWidth() const
+{
+	return mWidth;
+}
+
+u32 FramebufferGL::GetHeight() const
+{
+	return mHeight;
+}
+
+u32 FramebufferGL::GetColorAttachmentCount() const
+{
+	return u32(mAttachments.size());
+}
+
+const TexturePtr& FramebufferGL::GetColorAttachment(u32 index) const
+{
+	ASSERT(index < mAttachments.size(), "Invalid color attachment");
+	return mAttachments[index];
+}
+
+u32 FramebufferGL::GetID() const
+{
+	if(!mID)
+	{
+		RenderDeviceGL::DeleteOrphans();
+		glCreateFramebuffers(1, &mID);
+		mOwner    = std::this_thread::get_id();
+		mAttached = false;
+	}
+
+	if(!mAttached)
+		Attach();
+
+	return mID;
+}
+
+void FramebufferGL::CreateAttachments()
+{
+	mAttachments.clear();
+	for(TextureFormat format : mFormats)
+		mAttachments.push_back(Texture::Create(mWidth, mHeight, format, mFiltered));
+
+	mAttached = false;
+}
+
+void FramebufferGL::Attach() const
+{
+	Vector<GLenum> buffers;
+	for(u32 i = 0; i < mAttachments.size(); ++i)
+	{
+		auto attachment = GLenum(GL_COLOR_ATTACHMENT0 + i);
+		glNamedFramebufferTexture(mID, attachment, mAttachments[i]->GetID(), 0);
+		buffers.push_back(attachment);
+	}
+	glNamedFramebufferDrawBuffers(mID, GLsizei(buffers.size()), buffers.data());
+	mAttached = true;
+
+	GLenum status = glCheckNamedFramebufferStatus(mID, GL_FRAMEBUFFER);
+	if(status != GL_FRAMEBUFFER_COMPLETE)
+		ERROR("Framebuffer %ux%u incomplete (0x%x)", mWidth, mHeight, status);
+}
@@ -0,0 +1,71 @@
+#include <FramebufferNull.hpp>
+
+#include <Assert.hpp>
+#include <RenderDeviceNull.hpp>
+
+FramebufferNull::FramebufferNull(u32                          width,
+                                 u32                          height,
+                                 const Vector<TextureFormat>& formats,
+                                 bool                         filter)
+        : mID(RenderDeviceNull::GenerateID()),
+          mWidth(width),
+          mHeight(height),
+          mFiltered(filter),
+          mFormats(formats)
+{
+	ASSERT(!mFormats.empty(), "Framebuffer without attachments");
+	CreateAttachments();
+}
+
+void FramebufferNull::Resize(u32 width, u32 height)
+{
+	if(width == mWidth && height == mHeight)
+		return;
+
+	mWidth  = width;
+	mHeight = height;
+	CreateAttachments();
+}
+
+void FramebufferNull::Clear(Color)
+{
+	RenderDeviceNull::Record(NullCommandType::Clear, mID, 0);
+}
+
+vec2ui FramebufferNull::GetResolution() const
+{
+	return {mWidth, mHeight};
+}
+
+u32 FramebufferNull::GetWidth() const
+{
+	return mWidth;
+}
+
+u32 FramebufferNull::GetHeight() const
+{
+	return mHeight;
+}
+
+u32 FramebufferNull::GetColorAttachmentCount() const
+{
+	return u32(mAttachments.size());
+}
+
+const TexturePtr& FramebufferNull::GetColorAttachment(u32 index) const
+{
+	ASSERT(index < mAttachments.size(), "Invalid color attachment");
+	return mAttachments[index];
+}
+
+u32 FramebufferNull::GetID() const
+{
+	return mID;
+}
+
+void FramebufferNull::CreateAttachments()
+{
+	mAttachments.clear();
+	for(TextureFormat format : mFormats)
+		mAttachments.push_back(Texture::Create(mWidth, mHeight, format, mFiltered));
+}
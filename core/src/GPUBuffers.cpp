@@ -2,15 +2,20 @@
 
 #include <Assert.hpp>
 #include <GPUBuffersGL.hpp>
+#include <GPUBuffersNull.hpp>
 #include <RenderDevice.hpp>
 
 VertexBufferPtr VertexBuffer::Create(std::initializer_list<Vertex> layout,
                                      u32                           count,
-                                     u32                           stride)
+                                     u32                           stride,
+                                     BufferUsage                   usage)
 {
 	switch(RenderDevice::GetAPI())
 	{
-	case RenderAPI::GL: return MakeShared<VertexBufferGL>(layout, count, stride);
+	case RenderAPI::None:
+		return MakeShared<VertexBufferNull>(layout, count, stride, usage);
+	case RenderAPI::GL:
+		return MakeShared<VertexBufferGL>(layout, count, stride, usage);
 	}
 	ASSERT(false, "Render API not supported");
 	return nullptr;
@@ -20,16 +25,40 @@ IndexBufferPtr IndexBuffer::Create(const u32* data, u32 count)
 {
 	switch(RenderDevice::GetAPI())
 	{
+	case RenderAPI::None: return MakeShared<IndexBufferNull>(data, count);
 	case RenderAPI::GL: return MakeShared<IndexBufferGL>(data, count);
 	}
 	ASSERT(false, "Render API not supported");
 	return nullptr;
 }
 
+IndirectBufferPtr IndirectBuffer::Create(u32 count)
+{
+	switch(RenderDevice::GetAPI())
+	{
+	case RenderAPI::None: return MakeShared<IndirectBufferNull>(count);
+	case RenderAPI::GL: return MakeShared<IndirectBufferGL>(count);
+	}
+	ASSERT(false, "Render API not supported");
+	return nullptr;
+}
+
+UniformBufferPtr UniformBuffer::Create(u32 size, u32 count)
+{
+	switch(RenderDevice::GetAPI())
+	{
+	case RenderAPI::None: return MakeShared<UniformBufferNull>(size, count);
+	case RenderAPI::GL: return MakeShared<UniformBufferGL>(size, count);
+	}
+	ASSERT(false, "Render API not supported");
+	return nullptr;
+}
+
 VertexArrayPtr VertexArray::Create()
 {
 	switch(RenderDevice::GetAPI())
 	{
+	case RenderAPI::None: return MakeShared<VertexArrayNull>();
 	case RenderAPI::GL: return MakeShared<VertexArrayGL>();
 	}
 	ASSERT(false, "Render API not supported");
@@ -45,13 +74,23 @@ u32 VertexTypeSize(VertexType type)
 	case VertexType::Bool: return 1;
 
 	case VertexType::UByte2:
-	case VertexType::Byte2: return 2;
+	case VertexType::Byte2:
+	case VertexType::UShort:
+	case VertexType::Half: return 2;
 
 	case VertexType::UByte3:
 	case VertexType::Byte3: return 3;
 
 	case VertexType::UByte4:
-	case VertexType::Byte4: return 4;
+	case VertexType::Byte4:
+	case VertexType::UShort2:
+	case VertexType::Half2: return 4;
+
+	case VertexType::UShort3:
+	case VertexType::Half3: return 6;
+
+	case VertexType::UShort4:
+	case VertexType::Half4: return 8;
 
 	case VertexType::Int:
 	case VertexType::UInt:
@@ -82,24 +121,32 @@ u32 VertexTypeCount(VertexType type)
 	case VertexType::UInt:
 	case VertexType::Byte:
 	case VertexType::UByte:
+	case VertexType::UShort:
+	case VertexType::Half:
 	case VertexType::Float: return 1;
 
 	case VertexType::Int2:
 	case VertexType::UInt2:
 	case VertexType::Byte2:
 	case VertexType::UByte2:
+	case VertexType::UShort2:
+	case VertexType::Half2:
 	case VertexType::Float2: return 2;
 
 	case VertexType::Int3:
 	case VertexType::UInt3:
 	case VertexType::Byte3:
 	case VertexType::UByte3:
+	case VertexType::UShort3:
+	case VertexType::Half3:
 	case VertexType::Float3: return 3;
 
 	case VertexType::Int4:
 	case VertexType::UInt4:
 	case VertexType::Byte4:
 	case VertexType::UByte4:
+	case VertexType::UShort4:
+	case VertexType::Half4:
 	case VertexType::Float4: return 4;
 
 	default: return 0;
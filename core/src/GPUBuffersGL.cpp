@@ -2,10 +2,20 @@
 
 #include <Assert.hpp>
 #include <Logger.hpp>
+#include <RenderDeviceGL.hpp>
+
+// Normally signaled long ago, we only block if the CPU is a whole ring ahead of
+// the GPU.
+static void WaitFence(GLsync fence)
+{
+	GLenum r = glClientWaitSync(fence, 0, 0);
+	while(r == GL_TIMEOUT_EXPIRED)
+		r = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+}
 
 VertexBufferGL::VertexBufferGL(std::initializer_list<Vertex> layout, u32 count,
-                               u32 stride)
-        : mLayout(layout), mCount(count), mStride(stride)
+                               u32 stride, BufferUsage usage)
+        : mLayout(layout), mCount(count), mStride(stride), mUsage(usage)
 {
 	u32 offset {0};
 	for(auto& e : mLayout)
@@ -14,11 +24,34 @@ VertexBufferGL::VertexBufferGL(std::initializer_list<Vertex> layout, u32 count,
 		offset += VertexTypeSize(e.Type);
 	}
 	glCreateBuffers(1, &mID);
-	glNamedBufferStorage(mID, count * mStride, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	if(mUsage == BufferUsage::Stream)
+	{
+		// Mapped once for the lifetime of the buffer, coherent so writes become
+		// visible to the GPU without explicit flushes.
+		const GLbitfield flags =
+		        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		const auto size = GLsizeiptr(count) * mStride * StreamRegionCount;
+
+		glNamedBufferStorage(mID, size, nullptr, flags);
+		mMapped = (u8*)glMapNamedBufferRange(mID, 0, size, flags);
+		ASSERT(mMapped, "Could not map stream buffer");
+	}
+	else
+	{
+		glNamedBufferStorage(mID, count * mStride, nullptr, GL_DYNAMIC_STORAGE_BIT);
+	}
 }
 
 VertexBufferGL::~VertexBufferGL()
 {
+	for(auto it = mFences.begin(); it != mFences.end(); ++it)
+		if(*it && std::find(mFences.begin(), it, *it) == it)
+			glDeleteSync(*it);
+
+	if(mMapped)
+		glUnmapNamedBuffer(mID);
+
 	glDeleteBuffers(1, &mID);
 }
 
@@ -39,9 +72,30 @@ u32 VertexBufferGL::GetCount() const
 
 void VertexBufferGL::SetData(const void* data, u32 count)
 {
+	if(mUsage == BufferUsage::Stream)
+	{
+		ERROR("Stream buffers are written through Map");
+		return;
+	}
+
 	glNamedBufferSubData(mID, 0, count * mStride, data);
 }
 
+void VertexBufferGL::SetSubData(const void* data, u32 count, u32 offset)
+{
+	if(mUsage == BufferUsage::Stream)
+	{
+		ERROR("Stream buffers are written through Map");
+		return;
+	}
+
+	ASSERT(offset + count <= mCount, "Range out of buffer");
+	glNamedBufferSubData(mID,
+	                     GLintptr(offset) * mStride,
+	                     GLsizeiptr(count) * mStride,
+	                     data);
+}
+
 u32 VertexBufferGL::GetStride() const
 {
 	return mStride;
@@ -52,6 +106,224 @@ u32 VertexBufferGL::GetID() const
 	return mID;
 }
 
+BufferUsage VertexBufferGL::GetUsage() const
+{
+	return mUsage;
+}
+
+void* VertexBufferGL::Map()
+{
+	if(mUsage != BufferUsage::Stream)
+	{
+		ERROR("Only stream buffers can be mapped");
+		return nullptr;
+	}
+
+	if(mOffset == mCount)
+	{
+		mRegion = (mRegion + 1) % StreamRegionCount;
+		mOffset = 0;
+	}
+
+	// entering the region, the GPU may still read it from the last time around
+	if(mOffset == 0 && mFences[mRegion])
+	{
+		WaitFence(mFences[mRegion]);
+		ReleaseFence(mRegion);
+	}
+
+	return mMapped + (size_t(mRegion) * mCount + mOffset) * mStride;
+}
+
+void VertexBufferGL::Unmap(u32 count)
+{
+	if(mUsage != BufferUsage::Stream)
+		return;
+
+	ASSERT(mOffset + count <= mCount, "Written past the stream region");
+
+	// one fence for the current region and the ones passed by Advance, it is
+	// signaled after the fences of earlier writes to them
+	GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	for(u32 i = 0; i <= mPending; ++i)
+	{
+		u32 region = (mRegion + StreamRegionCount - i) % StreamRegionCount;
+		ReleaseFence(region);
+		mFences[region] = fence;
+	}
+
+	mPending  = 0;
+	mOffset  += count;
+}
+
+void VertexBufferGL::Advance()
+{
+	if(mUsage != BufferUsage::Stream)
+		return;
+
+	ASSERT(mPending + 2 < StreamRegionCount, "Too many stream regions unfenced");
+	++mPending;
+	mRegion = (mRegion + 1) % StreamRegionCount;
+	mOffset = 0;
+}
+
+u32 VertexBufferGL::GetRoom() const
+{
+	return mCount - mOffset;
+}
+
+u32 VertexBufferGL::GetBaseVertex() const
+{
+	return mRegion * mCount + mOffset;
+}
+
+void VertexBufferGL::ReleaseFence(u32 region)
+{
+	GLsync fence    = mFences[region];
+	mFences[region] = nullptr;
+
+	// the last region referencing the fence deletes it
+	if(fence && std::find(mFences.begin(), mFences.end(), fence) == mFences.end())
+		glDeleteSync(fence);
+}
+
+void VertexBufferGL::BindStorage(u32 binding) const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, mID);
+}
+
+
+IndirectBufferGL::IndirectBufferGL(u32 count): mCount(count)
+{
+	const GLbitfield flags =
+	        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	const auto size =
+	        GLsizeiptr(count * sizeof(DrawIndexedCommand)) * StreamRegionCount;
+
+	glCreateBuffers(1, &mID);
+	glNamedBufferStorage(mID, size, nullptr, flags);
+	mMapped = (DrawIndexedCommand*)glMapNamedBufferRange(mID, 0, size, flags);
+	ASSERT(mMapped, "Could not map indirect buffer");
+}
+
+IndirectBufferGL::~IndirectBufferGL()
+{
+	for(GLsync fence : mFences)
+		if(fence)
+			glDeleteSync(fence);
+
+	glUnmapNamedBuffer(mID);
+	glDeleteBuffers(1, &mID);
+}
+
+u32 IndirectBufferGL::GetCount() const
+{
+	return mCount;
+}
+
+u32 IndirectBufferGL::GetID() const
+{
+	return mID;
+}
+
+DrawIndexedCommand* IndirectBufferGL::Map()
+{
+	GLsync& fence = mFences[mRegion];
+	if(fence)
+	{
+		WaitFence(fence);
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	return mMapped + size_t(mRegion) * mCount;
+}
+
+void IndirectBufferGL::Unmap()
+{
+	mFences[mRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	mRegion          = (mRegion + 1) % StreamRegionCount;
+}
+
+u32 IndirectBufferGL::GetBaseCommand() const
+{
+	return mRegion * mCount;
+}
+
+
+UniformBufferGL::UniformBufferGL(u32 size, u32 count)
+        : mCount(count),
+          mSize(size)
+{
+	// records are bound at multiples of the alignment
+	GLint alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	mStride = (size + u32(alignment) - 1) / u32(alignment) * u32(alignment);
+
+	const GLbitfield flags =
+	        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	const auto size_all = GLsizeiptr(count) * mStride * StreamRegionCount;
+
+	glCreateBuffers(1, &mID);
+	glNamedBufferStorage(mID, size_all, nullptr, flags);
+	mMapped = (u8*)glMapNamedBufferRange(mID, 0, size_all, flags);
+	ASSERT(mMapped, "Could not map uniform buffer");
+}
+
+UniformBufferGL::~UniformBufferGL()
+{
+	for(GLsync fence : mFences)
+		if(fence)
+			glDeleteSync(fence);
+
+	glUnmapNamedBuffer(mID);
+	glDeleteBuffers(1, &mID);
+}
+
+u32 UniformBufferGL::GetCount() const
+{
+	return mCount;
+}
+
+u32 UniformBufferGL::GetStride() const
+{
+	return mStride;
+}
+
+u32 UniformBufferGL::GetID() const
+{
+	return mID;
+}
+
+void* UniformBufferGL::Map()
+{
+	GLsync& fence = mFences[mRegion];
+	if(fence)
+	{
+		WaitFence(fence);
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	return mMapped + size_t(mRegion) * mCount * mStride;
+}
+
+void UniformBufferGL::Unmap()
+{
+	mFences[mRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	mRegion          = (mRegion + 1) % StreamRegionCount;
+}
+
+void UniformBufferGL::Bind(u32 binding, u32 index) const
+{
+	ASSERT(index < mCount, "Record out of buffer");
+	glBindBufferRange(GL_UNIFORM_BUFFER,
+	                  binding,
+	                  mID,
+	                  GLintptr(mRegion * mCount + index) * mStride,
+	                  mSize);
+}
+
 
 IndexBufferGL::IndexBufferGL(const u32* data, u32 count): mCount(count)
 {
@@ -81,39 +353,60 @@ u32 IndexBufferGL::GetID() const
 }
 
 
-VertexArrayGL::VertexArrayGL()
-{
-	glCreateVertexArrays(1, &mID);
-}
-
 VertexArrayGL::~VertexArrayGL()
 {
-	glDeleteVertexArrays(1, &mID);
+	RenderDeviceGL::DeleteContainer(
+	        RenderDeviceGL::ContainerType::VertexArray, mID, mOwner);
 }
 
 void VertexArrayGL::AttachIndexBuffer(const IndexBufferPtr& ib)
 {
 	mIB = ib;
-	glVertexArrayElementBuffer(mID, ib->GetID());
+	if(mID)
+		glVertexArrayElementBuffer(mID, ib->GetID());
+}
+
+void VertexArrayGL::AttachVertexBuffer(const VertexBufferPtr& vb, u32 divisor)
+{
+	mVBList.push_back(vb);
+	mDivisors.push_back(divisor);
+	if(mID)
+		SetupVertexBuffer(vb, divisor);
+}
+
+void VertexArrayGL::Create() const
+{
+	RenderDeviceGL::DeleteOrphans();
+
+	glCreateVertexArrays(1, &mID);
+	mOwner = std::this_thread::get_id();
+
+	if(mIB)
+		glVertexArrayElementBuffer(mID, mIB->GetID());
+	for(u32 i = 0; i < mVBList.size(); ++i)
+		SetupVertexBuffer(mVBList[i], mDivisors[i]);
 }
 
-void VertexArrayGL::AttachVertexBuffer(const VertexBufferPtr& vb)
+void VertexArrayGL::SetupVertexBuffer(const VertexBufferPtr& vb, u32 divisor) const
 {
 	glVertexArrayVertexBuffer(mID, mVBIndex, vb->GetID(), 0,
 	                          (GLsizei)vb->GetStride());
+	glVertexArrayBindingDivisor(mID, mVBIndex, divisor);
 
 	auto layout  = vb->GetLayout();
 	auto attribs = u32(layout.size());
 
-	for(u32 i = 0; i < attribs; ++i)
+	// attribute locations continue after the previously attached buffers
+	for(u32 l = 0; l < attribs; ++l)
 	{
-		VertexType type   = layout[i].Type;
-		u32        offset = layout[i].Offset;
+		VertexType type   = layout[l].Type;
+		u32        offset = layout[l].Offset;
+		u32        i      = mAttribIndex++;
 
 		glEnableVertexArrayAttrib(mID, i);
 		glVertexArrayAttribBinding(mID, i, mVBIndex);
 
-		if(layout[i].Normalize)
+		if(layout[l].Normalize)
 		{
 			glVertexArrayAttribFormat(mID, i, (GLint)VertexTypeCount(type),
 			                          VertexTypeMap(type), GL_TRUE, offset);
@@ -126,6 +419,10 @@ void VertexArrayGL::AttachVertexBuffer(const VertexBufferPtr& vb)
 		case VertexType::Float2:
 		case VertexType::Float3:
 		case VertexType::Float4:
+		case VertexType::Half:
+		case VertexType::Half2:
+		case VertexType::Half3:
+		case VertexType::Half4:
 		{
 			glVertexArrayAttribFormat(mID, i, (GLint)VertexTypeCount(type),
 			                          VertexTypeMap(type), GL_FALSE, offset);
@@ -140,6 +437,10 @@ void VertexArrayGL::AttachVertexBuffer(const VertexBufferPtr& vb)
 		case VertexType::UByte2:
 		case VertexType::UByte3:
 		case VertexType::UByte4:
+		case VertexType::UShort:
+		case VertexType::UShort2:
+		case VertexType::UShort3:
+		case VertexType::UShort4:
 		case VertexType::Bool:
 		case VertexType::UInt:
 		case VertexType::UInt2:
@@ -159,7 +460,6 @@ void VertexArrayGL::AttachVertexBuffer(const VertexBufferPtr& vb)
 		}
 	}
 
-	mVBList.push_back(vb);
 	++mVBIndex;
 }
 
@@ -192,6 +492,9 @@ IndexBufferPtr VertexArrayGL::GetIndexBuffer() const
 
 void VertexArrayGL::Bind() const
 {
+	if(!mID)
+		Create();
+
 	glBindVertexArray(mID);
 }
 
@@ -226,6 +529,16 @@ u32 VertexArrayGL::VertexTypeMap(VertexType type)
 	case VertexType::UByte3:
 	case VertexType::UByte4: return GL_UNSIGNED_BYTE;
 
+	case VertexType::UShort:
+	case VertexType::UShort2:
+	case VertexType::UShort3:
+	case VertexType::UShort4: return GL_UNSIGNED_SHORT;
+
+	case VertexType::Half:
+	case VertexType::Half2:
+	case VertexType::Half3:
+	case VertexType::Half4: return GL_HALF_FLOAT;
+
 	case VertexType::Byte:
 	case VertexType::Byte2:
 	case VertexType::Byte3:
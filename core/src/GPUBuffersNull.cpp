@@ -0,0 +1,259 @@
+#include <GPUBuffersNull.hpp>
+
+#include <Assert.hpp>
+#include <Logger.hpp>
+#include <RenderDeviceNull.hpp>
+
+VertexBufferNull::VertexBufferNull(std::initializer_list<Vertex> layout,
+                                   u32                           count,
+                                   u32                           stride,
+                                   BufferUsage                   usage)
+        : mID(RenderDeviceNull::GenerateID()),
+          mLayout(layout),
+          mCount(count),
+          mStride(stride),
+          mUsage(usage)
+{
+	u32 offset {0};
+	for(auto& e : mLayout)
+	{
+		e.Offset  = offset;
+		offset   += VertexTypeSize(e.Type);
+	}
+
+	if(mUsage == BufferUsage::Stream)
+		mMemory.resize(size_t(count) * mStride * StreamRegionCount);
+}
+
+const Vector<Vertex>& VertexBufferNull::GetLayout() const
+{
+	return mLayout;
+}
+
+void VertexBufferNull::SetLayout(std::initializer_list<Vertex> layout)
+{
+	mLayout = layout;
+}
+
+u32 VertexBufferNull::GetCount() const
+{
+	return mCount;
+}
+
+void VertexBufferNull::SetData(const void* data, u32 count)
+{
+	if(mUsage == BufferUsage::Stream)
+	{
+		ERROR("Stream buffers are written through Map");
+		return;
+	}
+
+	RenderDeviceNull::Record(NullCommandType::UploadBuffer, mID, count * mStride);
+}
+
+void VertexBufferNull::SetSubData(const void*, u32 count, u32 offset)
+{
+	if(mUsage == BufferUsage::Stream)
+	{
+		ERROR("Stream buffers are written through Map");
+		return;
+	}
+
+	ASSERT(offset + count <= mCount, "Range out of buffer");
+	RenderDeviceNull::Record(NullCommandType::UploadBuffer, mID, count * mStride);
+}
+
+u32 VertexBufferNull::GetStride() const
+{
+	return mStride;
+}
+
+u32 VertexBufferNull::GetID() const
+{
+	return mID;
+}
+
+BufferUsage VertexBufferNull::GetUsage() const
+{
+	return mUsage;
+}
+
+void* VertexBufferNull::Map()
+{
+	if(mUsage != BufferUsage::Stream)
+	{
+		ERROR("Only stream buffers can be mapped");
+		return nullptr;
+	}
+
+	if(mOffset == mCount)
+	{
+		mRegion = (mRegion + 1) % StreamRegionCount;
+		mOffset = 0;
+	}
+
+	return mMemory.data() + (size_t(mRegion) * mCount + mOffset) * mStride;
+}
+
+void VertexBufferNull::Unmap(u32 count)
+{
+	if(mUsage != BufferUsage::Stream)
+		return;
+
+	ASSERT(mOffset + count <= mCount, "Written past the stream region");
+	mPending  = 0;
+	mOffset  += count;
+}
+
+void VertexBufferNull::Advance()
+{
+	if(mUsage != BufferUsage::Stream)
+		return;
+
+	ASSERT(mPending + 2 < StreamRegionCount, "Too many stream regions unfenced");
+	++mPending;
+	mRegion = (mRegion + 1) % StreamRegionCount;
+	mOffset = 0;
+}
+
+u32 VertexBufferNull::GetRoom() const
+{
+	return mCount - mOffset;
+}
+
+u32 VertexBufferNull::GetBaseVertex() const
+{
+	return mRegion * mCount + mOffset;
+}
+
+void VertexBufferNull::BindStorage(u32) const {}
+
+
+IndirectBufferNull::IndirectBufferNull(u32 count)
+        : mID(RenderDeviceNull::GenerateID()),
+          mCount(count),
+          mCommands(size_t(count) * StreamRegionCount)
+{
+}
+
+u32 IndirectBufferNull::GetCount() const
+{
+	return mCount;
+}
+
+u32 IndirectBufferNull::GetID() const
+{
+	return mID;
+}
+
+DrawIndexedCommand* IndirectBufferNull::Map()
+{
+	return mCommands.data() + size_t(mRegion) * mCount;
+}
+
+void IndirectBufferNull::Unmap()
+{
+	mRegion = (mRegion + 1) % StreamRegionCount;
+}
+
+u32 IndirectBufferNull::GetBaseCommand() const
+{
+	return mRegion * mCount;
+}
+
+const DrawIndexedCommand* IndirectBufferNull::GetCommands() const
+{
+	return mCommands.data();
+}
+
+
+UniformBufferNull::UniformBufferNull(u32 size, u32 count)
+        : mID(RenderDeviceNull::GenerateID()),
+          mCount(count),
+          mStride(size),
+          mRecords(size_t(count) * size * StreamRegionCount)
+{
+}
+
+u32 UniformBufferNull::GetCount() const
+{
+	return mCount;
+}
+
+u32 UniformBufferNull::GetStride() const
+{
+	return mStride;
+}
+
+u32 UniformBufferNull::GetID() const
+{
+	return mID;
+}
+
+void* UniformBufferNull::Map()
+{
+	return mRecords.data() + size_t(mRegion) * mCount * mStride;
+}
+
+void UniformBufferNull::Unmap()
+{
+	mRegion = (mRegion + 1) % StreamRegionCount;
+}
+
+void UniformBufferNull::Bind(u32, u32 index) const
+{
+	ASSERT(index < mCount, "Record out of buffer");
+}
+
+
+IndexBufferNull::IndexBufferNull(const u32* data, u32 count)
+        : mID(RenderDeviceNull::GenerateID())
+{
+	SetData(data, count);
+}
+
+u32 IndexBufferNull::GetCount() const
+{
+	return mCount;
+}
+
+void IndexBufferNull::SetData(const u32*, u32 count)
+{
+	mCount = count;
+	RenderDeviceNull::Record(NullCommandType::UploadBuffer, mID, count * 4);
+}
+
+u32 IndexBufferNull::GetID() const
+{
+	return mID;
+}
+
+
+void VertexArrayNull::AttachIndexBuffer(const IndexBufferPtr& ib)
+{
+	mIB = ib;
+}
+
+void VertexArrayNull::AttachVertexBuffer(const VertexBufferPtr& vb, u32)
+{
+	mVBList.push_back(vb);
+}
+
+u32 VertexArrayNull::GetVertexBufferCount() const
+{
+	return u32(mVBList.size());
+}
+
+VertexBufferPtr VertexArrayNull::GetVertexBuffer(u32 i) const
+{
+	return mVBList[i];
+}
+
+IndexBufferPtr VertexArrayNull::GetIndexBuffer() const
+{
+	return mIB;
+}
+
+void VertexArrayNull::Bind() const {}
+
+void VertexArrayNull::Unbind() const {}
@@ -0,0 +1,119 @@
+#include <GPUProfiler.hpp>
+
+#include <Assert.hpp>
+
+GPUProfiler::GPUProfiler(u32 max_zones)
+        : mMaxZones(max_zones),
+          mFrameIndex(0),
+          mMeasuring(false),
+          mFrames(FrameLatency),
+          mFrameTime(0.0)
+{
+	for(Frame& frame : mFrames)
+	{
+		frame.Elapsed = TimerQuery::Create();
+		frame.Pending = false;
+	}
+}
+
+void GPUProfiler::BeginFrame()
+{
+	ASSERT(!mMeasuring, "GPUProfiler::EndFrame was not called");
+
+	mFrameIndex  = (mFrameIndex + 1) % FrameLatency;
+	Frame& frame = mFrames[mFrameIndex];
+
+	// the oldest frame of the ring, normally done long ago
+	if(frame.Pending)
+	{
+		if(!IsDone(frame))
+			return;
+		Collect(frame);
+	}
+
+	frame.Names.clear();
+	frame.Elapsed->Begin();
+	mMeasuring = true;
+}
+
+void GPUProfiler::EndFrame()
+{
+	ASSERT(mOpenZones.empty(), "GPU zone not ended");
+
+	if(!mMeasuring)
+		return;
+
+	mFrames[mFrameIndex].Elapsed->End();
+	mFrames[mFrameIndex].Pending = true;
+	mMeasuring                   = false;
+}
+
+void GPUProfiler::BeginZone(const char* name)
+{
+	Frame& frame = mFrames[mFrameIndex];
+
+	if(!mMeasuring || frame.Names.size() == mMaxZones)
+	{
+		mOpenZones.push_back(~0u);
+		return;
+	}
+
+	auto zone = u32(frame.Names.size());
+	frame.Names.push_back(name);
+	if(frame.Stamps.size() < (zone + 1) * 2)
+	{
+		frame.Stamps.push_back(TimerQuery::Create());
+		frame.Stamps.push_back(TimerQuery::Create());
+	}
+
+	frame.Stamps[zone * 2]->Timestamp();
+	mOpenZones.push_back(zone);
+}
+
+void GPUProfiler::EndZone()
+{
+	ASSERT(!mOpenZones.empty(), "GPU zone not begun");
+
+	u32 zone = mOpenZones.back();
+	mOpenZones.pop_back();
+
+	if(zone != ~0u)
+		mFrames[mFrameIndex].Stamps[zone * 2 + 1]->Timestamp();
+}
+
+bool GPUProfiler::IsDone(const Frame& frame) const
+{
+	if(!frame.Elapsed->IsAvailable())
+		return false;
+
+	for(u32 i = 0; i < frame.Names.size() * 2; ++i)
+		if(!frame.Stamps[i]->IsAvailable())
+			return false;
+	return true;
+}
+
+void GPUProfiler::Collect(Frame& frame)
+{
+	mFrameTime = double(frame.Elapsed->GetResult()) * 1e-6;
+
+	mZones.clear();
+	for(u32 i = 0; i < frame.Names.size(); ++i)
+	{
+		u64 begin = frame.Stamps[i * 2]->GetResult();
+		u64 end   = frame.Stamps[i * 2 + 1]->GetResult();
+
+		const char* name = frame.Names[i];
+
+		auto it = std::find_if(mZones.begin(),
+		                       mZones.end(),
+		                       [name](const Zone& zone)
+		                       { return std::strcmp(zone.Name, name) == 0; });
+		if(it == mZones.end())
+			it = mZones.insert(mZones.end(), {name, 0.0, 0});
+
+		it->Time += double(end - begin) * 1e-6;
+		++it->Count;
+	}
+
+	frame.Pending = false;
+}
@@ -2,14 +2,16 @@
 
 #include <Assert.hpp>
 #include <RenderDeviceGL.hpp>
+#include <RenderDeviceNull.hpp>
 
 RenderAPI RenderDevice::sAPI = RenderAPI::GL;
 
-RenderDevicePtr RenderDevice::Create()
+RenderDevicePtr RenderDevice::Create(const Window& window)
 {
 	switch(sAPI)
 	{
-	case RenderAPI::GL: return MakeUnique<RenderDeviceGL>();
+	case RenderAPI::None: return MakeUnique<RenderDeviceNull>();
+	case RenderAPI::GL: return MakeUnique<RenderDeviceGL>(window);
 	}
 	ASSERT(false, "Render API not supported");
 	return nullptr;
@@ -20,6 +22,11 @@ RenderAPI RenderDevice::GetAPI()
 	return sAPI;
 }
 
+void RenderDevice::SetAPI(RenderAPI api)
+{
+	sAPI = api;
+}
+
 const RenderDeviceInfo& RenderDevice::GetInfo() const
 {
 	return mInfo;
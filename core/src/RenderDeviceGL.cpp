@@ -2,12 +2,72 @@
 
 #include <Assert.hpp>
 #include <Logger.hpp>
+#include <ShaderGL.hpp>
+#include <Window.hpp>
 
-RenderDeviceGL::RenderDeviceGL()
+struct OrphanContainer
+{
+	RenderDeviceGL::ContainerType Type;
+	u32                           ID;
+	std::thread::id               Owner;
+};
+
+static std::mutex              sOrphanMutex;
+static Vector<OrphanContainer> sOrphans;
+
+static void Delete(RenderDeviceGL::ContainerType type, u32 id)
+{
+	if(type == RenderDeviceGL::ContainerType::VertexArray)
+		glDeleteVertexArrays(1, &id);
+	else
+		glDeleteFramebuffers(1, &id);
+}
+
+static GLADapiproc LoadProc(void* window, const char* name)
+{
+	return static_cast<const Window*>(window)->GetProcAddress(name);
+}
+
+static bool HasExtension(const char* name)
+{
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+	for(GLint i = 0; i < count; ++i)
+	{
+		auto* extension = (const char*)glGetStringi(GL_EXTENSIONS, GLuint(i));
+		if(std::strcmp(extension, name) == 0)
+			return true;
+	}
+	return false;
+}
+
+// KHR_parallel_shader_compile and its ARB twin, the loader knows neither
+static bool EnableParallelCompile(const Window& window)
+{
+	using MaxThreadsProc = void(GLAD_API_PTR*)(GLuint count);
+
+	MaxThreadsProc max_threads = nullptr;
+	if(HasExtension("GL_KHR_parallel_shader_compile"))
+		max_threads = reinterpret_cast<MaxThreadsProc>(
+		        window.GetProcAddress("glMaxShaderCompilerThreadsKHR"));
+	else if(HasExtension("GL_ARB_parallel_shader_compile"))
+		max_threads = reinterpret_cast<MaxThreadsProc>(
+		        window.GetProcAddress("glMaxShaderCompilerThreadsARB"));
+
+	if(!max_threads)
+		return false;
+
+	// as many threads as the driver likes
+	max_threads(0xFFFFFFFF);
+	return true;
+}
+
+RenderDeviceGL::RenderDeviceGL(const Window& window)
 {
 	TRACE("RenderDevice initializing...");
 
-	int s = gladLoadGL(glfwGetProcAddress);
+	int s = gladLoadGLUserPtr(LoadProc, const_cast<Window*>(&window));
 	ASSERT(s != 0, "OpenGL initialization failed");
 
 	int mj = GLAD_VERSION_MAJOR(s);
@@ -51,6 +111,7 @@ RenderDeviceGL::RenderDeviceGL()
 		mInfo.BC4BC5 = mInfo.DriverVersion.major >= 3;  // supported in opengl 3.0+
 		mInfo.BC6HBC7 =
 		        GLAD_GL_ARB_texture_compression_bptc;  // supported in opengl 4.2+
+		mInfo.ParallelCompile = EnableParallelCompile(window);
 
 		glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, (int*)&mInfo.NumTextureUnits);
 		glGetIntegerv(GL_MAX_TEXTURE_SIZE, (int*)&mInfo.MaxTextureWidth);
@@ -76,12 +137,30 @@ RenderDeviceGL::RenderDeviceGL()
 		INFO("PVRTC Support: %s", mInfo.PVRTC);
 		INFO("BC4_5 Support: %s", mInfo.BC4BC5);
 		INFO("BC6_7 Support: %s", mInfo.BC6HBC7);
+		INFO("Parallel Shader Compile: %s", mInfo.ParallelCompile);
 	}
 
+	ShaderGL::EnableParallelCompile(mInfo.ParallelCompile);
+
 	EnableBlending(true);
 	SetBlendFunc(BlendFunc::SrcAlpha, BlendFunc::OneMinusSrcAlpha, Color::WHITE);
 	glEnable(GL_LINE_SMOOTH);
 
+	// the window's until the first UpdateViewport
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	mViewportPosition = {u32(viewport[0]), u32(viewport[1])};
+	mViewportSize     = {u32(viewport[2]), u32(viewport[3])};
+
+	// a headless context has no window framebuffer to draw to
+	if(window.IsHeadless())
+	{
+		vec2ui size   = window.GetResolution();
+		mBackBuffer   = Framebuffer::Create(size.x, size.y, {TextureFormat::RGBA8});
+		mViewportSize = size;
+		BindDefaultTarget();
+	}
+
 	TRACE("RenderDevice initialized");
 }
 
@@ -117,6 +196,22 @@ void RenderDeviceGL::SetBlendFunc(BlendFunc src, BlendFunc dst, Color color)
 	glBlendColor(c[0], c[1], c[2], c[3]);
 }
 
+void RenderDeviceGL::SetBlendFuncSeparate(BlendFunc src_color,
+                                          BlendFunc dst_color,
+                                          BlendFunc src_alpha,
+                                          BlendFunc dst_alpha,
+                                          Color     color)
+{
+	glBlendFuncSeparate((GLenum)BlendFuncMap(src_color),
+	                    (GLenum)BlendFuncMap(dst_color),
+	                    (GLenum)BlendFuncMap(src_alpha),
+	                    (GLenum)BlendFuncMap(dst_alpha));
+
+	float c[4];
+	color.GetColors(c);
+	glBlendColor(c[0], c[1], c[2], c[3]);
+}
+
 bool RenderDeviceGL::IsBlendingEnable() const
 {
 	return glIsEnabled(GL_BLEND) == GL_TRUE;
@@ -124,7 +219,51 @@ bool RenderDeviceGL::IsBlendingEnable() const
 
 void RenderDeviceGL::UpdateViewport(u32 x, u32 y, u32 width, u32 height)
 {
-	glViewport(GLint(x), GLint(y), GLsizei(width), GLsizei(height));
+	mViewportPosition = {x, y};
+	mViewportSize     = {width, height};
+
+	if(mBackBuffer)
+		mBackBuffer->Resize(x + width, y + height);
+
+	if(!mRenderTarget)
+		BindDefaultTarget();
+}
+
+vec2ui RenderDeviceGL::GetViewportSize() const
+{
+	return mViewportSize;
+}
+
+void RenderDeviceGL::SetRenderTarget(const FramebufferPtr& target)
+{
+	mRenderTarget = target;
+
+	if(target)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, target->GetID());
+		glViewport(0, 0, GLsizei(target->GetWidth()), GLsizei(target->GetHeight()));
+	}
+	else
+		BindDefaultTarget();
+}
+
+const FramebufferPtr& RenderDeviceGL::GetRenderTarget() const
+{
+	return mRenderTarget;
+}
+
+const FramebufferPtr& RenderDeviceGL::GetBackBuffer() const
+{
+	return mBackBuffer;
+}
+
+void RenderDeviceGL::BindDefaultTarget()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, mBackBuffer ? mBackBuffer->GetID() : 0);
+	glViewport(GLint(mViewportPosition.x),
+	           GLint(mViewportPosition.y),
+	           GLsizei(mViewportSize.x),
+	           GLsizei(mViewportSize.y));
 }
 
 void RenderDeviceGL::SetPointSize(float size)
@@ -132,11 +271,113 @@ void RenderDeviceGL::SetPointSize(float size)
 	glPointSize(size);
 }
 
-void RenderDeviceGL::DrawIndexed(const VertexArrayPtr& va, u32 index_count)
+void RenderDeviceGL::Flush()
+{
+	glFlush();
+}
+
+GPUFence RenderDeviceGL::CreateFence()
+{
+	GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	// other contexts only see a fence that was flushed
+	glFlush();
+	return fence;
+}
+
+void RenderDeviceGL::WaitFence(GPUFence fence)
+{
+	if(!fence)
+		return;
+
+	glWaitSync(GLsync(fence), 0, GL_TIMEOUT_IGNORED);
+	glDeleteSync(GLsync(fence));
+}
+
+void RenderDeviceGL::DeleteContainer(ContainerType   type,
+                                     u32             id,
+                                     std::thread::id owner)
+{
+	if(id == 0)
+		return;
+
+	if(owner == std::this_thread::get_id())
+	{
+		Delete(type, id);
+		return;
+	}
+
+	std::lock_guard lock(sOrphanMutex);
+	sOrphans.push_back({type, id, owner});
+}
+
+void RenderDeviceGL::DeleteOrphans()
+{
+	std::lock_guard lock(sOrphanMutex);
+	if(sOrphans.empty())
+		return;
+
+	auto thread = std::this_thread::get_id();
+	u32  kept   = 0;
+	for(const OrphanContainer& orphan : sOrphans)
+	{
+		if(orphan.Owner == thread)
+			Delete(orphan.Type, orphan.ID);
+		else
+			sOrphans[kept++] = orphan;
+	}
+	sOrphans.resize(kept);
+}
+
+void RenderDeviceGL::Draw(const VertexArrayPtr& va,
+                          u32                   vertex_count,
+                          u32                   first_vertex)
+{
+	va->Bind();
+	glDrawArrays(GL_TRIANGLES, (GLint)first_vertex, (GLsizei)vertex_count);
+}
+
+void RenderDeviceGL::DrawIndexed(const VertexArrayPtr& va,
+                                 u32                   index_count,
+                                 u32                   base_vertex)
+{
+	u32 count = index_count ? index_count : va->GetIndexBuffer()->GetCount();
+	va->Bind();
+	glDrawElementsBaseVertex(GL_TRIANGLES,
+	                         (GLsizei)count,
+	                         GL_UNSIGNED_INT,
+	                         nullptr,
+	                         (GLint)base_vertex);
+}
+
+void RenderDeviceGL::DrawIndexedInstanced(const VertexArrayPtr& va,
+                                          u32                   index_count,
+                                          u32                   instance_count,
+                                          u32                   base_instance)
 {
 	u32 count = index_count ? index_count : va->GetIndexBuffer()->GetCount();
 	va->Bind();
-	glDrawElements(GL_TRIANGLES, (GLsizei)count, GL_UNSIGNED_INT, nullptr);
+	glDrawElementsInstancedBaseInstance(GL_TRIANGLES,
+	                                    (GLsizei)count,
+	                                    GL_UNSIGNED_INT,
+	                                    nullptr,
+	                                    (GLsizei)instance_count,
+	                                    base_instance);
+}
+
+void RenderDeviceGL::DrawIndexedIndirect(const VertexArrayPtr&    va,
+                                         const IndirectBufferPtr& commands,
+                                         u32                      first,
+                                         u32                      count)
+{
+	va->Bind();
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands->GetID());
+	glMultiDrawElementsIndirect(
+	        GL_TRIANGLES,
+	        GL_UNSIGNED_INT,
+	        (const void*)(uintptr_t(first) * sizeof(DrawIndexedCommand)),
+	        (GLsizei)count,
+	        0);
 }
 
 i32 RenderDeviceGL::BlendFuncMap(BlendFunc func)
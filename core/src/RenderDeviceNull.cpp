@@ -0,0 +1,243 @@
+#include <RenderDeviceNull.hpp>
+
+#include <GPUBuffersNull.hpp>
+#include <Logger.hpp>
+
+// Like a current GL context, the objects of the backend report to it. Objects
+// may be used on a render thread and the thread that created them at once.
+static RenderDeviceNull* sDevice {nullptr};
+static std::mutex        sMutex;
+
+RenderDeviceNull::RenderDeviceNull()
+{
+	TRACE("RenderDevice initializing...");
+
+	mInfo.Name             = "Null";
+	mInfo.Vendor           = "Engine";
+	mInfo.NumTextureUnits  = 32;
+	mInfo.MaxTextureWidth  = 16384;
+	mInfo.MaxTextureHeight = 16384;
+	mInfo.NumSamples       = 1;
+
+	INFO("Render API: None, nothing reaches a GPU");
+
+	EnableBlending(true);
+	sDevice = this;
+
+	TRACE("RenderDevice initialized");
+}
+
+RenderDeviceNull::~RenderDeviceNull()
+{
+	sDevice = nullptr;
+
+	using ull = unsigned long long;
+	INFO("Null device: %llu draw calls (%llu commands), %llu vertices, %llu "
+	     "instances",
+	     ull(mCounters.DrawCalls),
+	     ull(mCounters.DrawCommands),
+	     ull(mCounters.Vertices),
+	     ull(mCounters.Instances));
+	INFO("Null device: %llu state changes, %llu clears, %llu shader binds, %llu "
+	     "texture binds",
+	     ull(mCounters.StateChanges),
+	     ull(mCounters.Clears),
+	     ull(mCounters.ShaderBinds),
+	     ull(mCounters.TextureBinds));
+	INFO("Null device: buffer uploads %.1f KiB, texture uploads %.1f KiB",
+	     double(mCounters.BufferBytes) / 1024.0,
+	     double(mCounters.TextureBytes) / 1024.0);
+}
+
+void RenderDeviceNull::SetClearColor(Color) {}
+
+void RenderDeviceNull::Clear()
+{
+	Record(NullCommandType::Clear, 0, 0);
+}
+
+void RenderDeviceNull::EnableBlending(bool enable)
+{
+	mBlending = enable;
+	Record(NullCommandType::SetBlend, 0, enable);
+}
+
+void RenderDeviceNull::SetBlendFunc(BlendFunc, BlendFunc, Color)
+{
+	Record(NullCommandType::SetBlend, 0, mBlending);
+}
+
+void RenderDeviceNull::SetBlendFuncSeparate(
+        BlendFunc, BlendFunc, BlendFunc, BlendFunc, Color)
+{
+	Record(NullCommandType::SetBlend, 0, mBlending);
+}
+
+bool RenderDeviceNull::IsBlendingEnable() const
+{
+	return mBlending;
+}
+
+void RenderDeviceNull::UpdateViewport(u32, u32, u32 width, u32 height)
+{
+	mViewportSize = {width, height};
+	Record(NullCommandType::SetViewport, 0, width * height);
+}
+
+vec2ui RenderDeviceNull::GetViewportSize() const
+{
+	return mViewportSize;
+}
+
+void RenderDeviceNull::SetRenderTarget(const FramebufferPtr& target)
+{
+	mRenderTarget = target;
+	Record(NullCommandType::SetRenderTarget, target ? target->GetID() : 0, 0);
+}
+
+const FramebufferPtr& RenderDeviceNull::GetRenderTarget() const
+{
+	return mRenderTarget;
+}
+
+const FramebufferPtr& RenderDeviceNull::GetBackBuffer() const
+{
+	return mBackBuffer;
+}
+
+void RenderDeviceNull::SetPointSize(float) {}
+
+void RenderDeviceNull::Flush() {}
+
+GPUFence RenderDeviceNull::CreateFence()
+{
+	return nullptr;
+}
+
+void RenderDeviceNull::WaitFence(GPUFence) {}
+
+void RenderDeviceNull::Draw(const VertexArrayPtr& va, u32 vertex_count, u32)
+{
+	va->Bind();
+	Record(NullCommandType::Draw, 0, vertex_count, 1);
+}
+
+void RenderDeviceNull::DrawIndexed(const VertexArrayPtr& va, u32 index_count, u32)
+{
+	u32 count = index_count ? index_count : va->GetIndexBuffer()->GetCount();
+	va->Bind();
+	Record(NullCommandType::DrawIndexed, 0, count, 1);
+}
+
+void RenderDeviceNull::DrawIndexedInstanced(const VertexArrayPtr& va,
+                                            u32                   index_count,
+                                            u32                   instance_count,
+                                            u32)
+{
+	u32 count = index_count ? index_count : va->GetIndexBuffer()->GetCount();
+	va->Bind();
+	Record(NullCommandType::DrawIndexedInstanced, 0, count, instance_count);
+}
+
+void RenderDeviceNull::DrawIndexedIndirect(const VertexArrayPtr&    va,
+                                           const IndirectBufferPtr& commands,
+                                           u32                      first,
+                                           u32                      count)
+{
+	va->Bind();
+
+	// The commands are in CPU memory, count what they would have drawn
+	auto* buffer = static_cast<const IndirectBufferNull*>(commands.get());
+	const DrawIndexedCommand* draws = buffer->GetCommands() + first;
+
+	u32 indices = 0, instances = 0;
+	for(u32 i = 0; i < count; ++i)
+	{
+		indices   += draws[i].IndexCount * draws[i].InstanceCount;
+		instances += draws[i].InstanceCount;
+	}
+
+	Record(NullCommandType::DrawIndexedIndirect,
+	       buffer->GetID(),
+	       indices,
+	       instances,
+	       count);
+}
+
+void RenderDeviceNull::SetRecording(bool enable)
+{
+	mRecording = enable;
+}
+
+bool RenderDeviceNull::IsRecording() const
+{
+	return mRecording;
+}
+
+const Vector<NullCommand>& RenderDeviceNull::GetCommands() const
+{
+	return mCommands;
+}
+
+void RenderDeviceNull::ClearCommands()
+{
+	mCommands.clear();
+}
+
+const NullDeviceCounters& RenderDeviceNull::GetCounters() const
+{
+	return mCounters;
+}
+
+void RenderDeviceNull::ResetCounters()
+{
+	mCounters = {};
+}
+
+void RenderDeviceNull::Record(NullCommandType type,
+                              u32             object,
+                              u32             count,
+                              u32             instances,
+                              u32             commands)
+{
+	if(!sDevice)
+		return;
+
+	std::lock_guard lock(sMutex);
+
+	NullDeviceCounters& c = sDevice->mCounters;
+	switch(type)
+	{
+	case NullCommandType::Clear: ++c.Clears; break;
+
+	case NullCommandType::SetBlend:
+	case NullCommandType::SetRenderTarget:
+	case NullCommandType::SetViewport: ++c.StateChanges; break;
+
+	case NullCommandType::Draw:
+	case NullCommandType::DrawIndexed:
+	case NullCommandType::DrawIndexedInstanced:
+	case NullCommandType::DrawIndexedIndirect:
+		++c.DrawCalls;
+		c.DrawCommands += commands;
+		c.Vertices  += type == NullCommandType::DrawIndexedInstanced
+		                       ? u64(count) * instances
+		                       : count;
+		c.Instances += instances;
+		break;
+
+	case NullCommandType::BindShader: ++c.ShaderBinds; break;
+	case NullCommandType::BindTexture: ++c.TextureBinds; break;
+	case NullCommandType::UploadBuffer: c.BufferBytes += count; break;
+	case NullCommandType::UploadTexture: c.TextureBytes += count; break;
+	}
+
+	if(sDevice->mRecording)
+		sDevice->mCommands.push_back({type, object, count, instances});
+}
+
+u32 RenderDeviceNull::GenerateID()
+{
+	static std::atomic<u32> sLastID {0};
+	return ++sLastID;
+}
@@ -0,0 +1,71 @@
+#include <RenderQueue.hpp>
+
+u64 RenderQueue::MakeKey(
+        u8 layer, u16 depth, BlendMode blend, PrimitiveType type, u32 texture)
+{
+	return (u64(layer) << 56) | (u64(depth) << 40) | (u64(blend) << 36) |
+	       (u64(type) << 32) | u64(texture);
+}
+
+void RenderQueue::Reserve(u32 count)
+{
+	mCommands.reserve(count);
+	mItems.reserve(count);
+	mScratch.reserve(count);
+}
+
+void RenderQueue::Clear()
+{
+	mCommands.clear();
+	mItems.clear();
+}
+
+RenderCommand& RenderQueue::Push(u64 key)
+{
+	mItems.push_back({key, u32(mCommands.size())});
+	return mCommands.emplace_back();
+}
+
+void RenderQueue::Sort()
+{
+	const auto count = u32(mItems.size());
+	if(count < 2)
+		return;
+
+	// Byte histograms for all 8 passes in one read, counts don't depend on order.
+	u32 histogram[8][256] {};
+	for(const SortItem& item : mItems)
+		for(u32 pass = 0; pass < 8; ++pass)
+			++histogram[pass][(item.Key >> (pass * 8)) & 0xff];
+
+	mScratch.resize(count);
+	SortItem* src = mItems.data();
+	SortItem* dst = mScratch.data();
+
+	for(u32 pass = 0; pass < 8; ++pass)
+	{
+		u32* h     = histogram[pass];
+		u32  shift = pass * 8;
+
+		// Most of the key is usually constant in a frame (one layer, one blend
+		// mode, ...), skip those bytes.
+		if(h[(src[0].Key >> shift) & 0xff] == count)
+			continue;
+
+		u32 offset = 0;
+		for(u32 b = 0; b < 256; ++b)
+		{
+			u32 c = h[b];
+			h[b]  = offset;
+			offset += c;
+		}
+
+		for(u32 i = 0; i < count; ++i)
+			dst[h[(src[i].Key >> shift) & 0xff]++] = src[i];
+
+		std::swap(src, dst);
+	}
+
+	if(src != mItems.data())
+		mItems.swap(mScratch);
+}
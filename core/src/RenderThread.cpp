@@ -0,0 +1,91 @@
+#include <RenderThread.hpp>
+
+#include <Logger.hpp>
+#include <Window.hpp>
+
+RenderThread::RenderThread(Window& window)
+        : mWindow(window)
+{
+	// a context is current on one thread at a time, hand it over before the
+	// render thread takes it
+	mWindow.MakeSharedContextCurrent();
+	mThread = std::thread(&RenderThread::Run, this);
+
+	INFO("Render thread started");
+}
+
+RenderThread::~RenderThread()
+{
+	{
+		std::lock_guard lock(mMutex);
+		mStopping = true;
+	}
+	mQueued.notify_one();
+	mThread.join();
+
+	mWindow.MakeContextCurrent();
+
+	INFO("Render thread stopped after %llu frames",
+	     (unsigned long long)mFrameCount.load());
+}
+
+u64 RenderThread::Submit(Job job)
+{
+	u64 ticket;
+	{
+		std::lock_guard lock(mMutex);
+		mJobs.push_back(std::move(job));
+		ticket = ++mSubmitted;
+	}
+	mQueued.notify_one();
+	return ticket;
+}
+
+void RenderThread::Wait(u64 ticket)
+{
+	std::unique_lock lock(mMutex);
+	if(ticket == 0)
+		ticket = mSubmitted;
+
+	mDone.wait(lock, [this, ticket] { return mCompleted >= ticket; });
+}
+
+void RenderThread::Present()
+{
+	u64 previous = mPresented;
+	mPresented   = Submit([this] { Swap(); });
+
+	if(previous != 0)
+		Wait(previous);
+}
+
+void RenderThread::Swap()
+{
+	mWindow.SwapBuffers();
+	++mFrameCount;
+}
+
+void RenderThread::Run()
+{
+	mWindow.MakeContextCurrent();
+
+	std::unique_lock lock(mMutex);
+	while(true)
+	{
+		mQueued.wait(lock, [this] { return mStopping || !mJobs.empty(); });
+		if(mJobs.empty())
+			break;
+
+		Job job = std::move(mJobs.front());
+		mJobs.pop_front();
+
+		lock.unlock();
+		job();
+		lock.lock();
+
+		++mCompleted;
+		mDone.notify_all();
+	}
+
+	mWindow.DetachContext();
+}
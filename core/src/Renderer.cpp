@@ -1,25 +1,502 @@
 #include <Renderer.hpp>
 
+#include <Assert.hpp>
+#include <CachedLayer.hpp>
 #include <Logger.hpp>
+#include <RenderThread.hpp>
+#include <StaticBatch.hpp>
+#include <Timer.hpp>
 
-Renderer::Renderer(RenderDevicePtr& device, u32 max_quads)
+// Stamps of the passes of every renderer, see Renderer::HoldTexture
+static std::atomic<u32> sPassStamp {0};
+
+#if ENGINE_CPU_X86_64
+	#include <emmintrin.h>
+
+static __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// sin(x) for x in [-pi, pi]: folded into [-pi/2, pi/2] then a degree 11
+// polynomial
+static __m128 Sin(__m128 x)
+{
+	const __m128 sign_mask = _mm_set1_ps(-0.0f);
+	const __m128 pi        = _mm_set1_ps(3.14159265f);
+	const __m128 half_pi   = _mm_set1_ps(1.57079633f);
+
+	__m128 sign   = _mm_and_ps(x, sign_mask);
+	__m128 absx   = _mm_andnot_ps(sign_mask, x);
+	__m128 folded = _mm_sub_ps(_mm_or_ps(pi, sign), x);  // sign(x) * pi - x
+	x             = Select(_mm_cmpgt_ps(absx, half_pi), folded, x);
+
+	__m128 x2 = _mm_mul_ps(x, x);
+	__m128 p  = _mm_set1_ps(-2.5052108e-8f);
+	p         = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(2.7557319e-6f));
+	p         = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.9841270e-4f));
+	p         = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(8.3333333e-3f));
+	p         = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.6666667e-1f));
+	p         = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f));
+	return _mm_mul_ps(p, x);
+}
+
+// sine and cosine of four angles in degrees
+static void SinCos(__m128 degrees, __m128& s, __m128& c)
+{
+	const __m128 deg2rad = _mm_set1_ps(float(CPI_180));
+	const __m128 inv_360 = _mm_set1_ps(1.0f / 360.0f);
+	const __m128 c360    = _mm_set1_ps(360.0f);
+	const __m128 half_pi = _mm_set1_ps(1.57079633f);
+	const __m128 pi      = _mm_set1_ps(3.14159265f);
+
+	// reduce to [-180, 180] before converting, keeps the error independent of
+	// the number of turns
+	__m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(degrees, inv_360)));
+	__m128 x     = _mm_mul_ps(_mm_sub_ps(degrees, _mm_mul_ps(turns, c360)), deg2rad);
+
+	s = Sin(x);
+
+	// cos(x) = sin(x + pi/2), wrap the shifted angle back into [-pi, pi]
+	x = _mm_add_ps(x, half_pi);
+	x = Select(_mm_cmpgt_ps(x, pi), _mm_sub_ps(x, _mm_add_ps(pi, pi)), x);
+	c = Sin(x);
+}
+#endif
+
+static u16 ToUNorm16(float value)
+{
+	return u16(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+// Local rectangle covering the shape, the quad drawn for it
+static void GetShapeBounds(const RenderCommand& command, vec2& min, vec2& max)
+{
+	const float* k = command.Params;
+
+	switch(command.Shape)
+	{
+	case ShapeType::Circle: max = vec2 {k[0]}; break;
+	case ShapeType::Box: max = {k[0], k[1]}; break;
+	case ShapeType::Capsule: max = {k[0] + k[1], k[1]}; break;
+	case ShapeType::Triangle:
+		min = {std::min({0.0f, k[0], k[2]}), std::min({0.0f, k[1], k[3]})};
+		max = {std::max({0.0f, k[0], k[2]}), std::max({0.0f, k[1], k[3]})};
+		return;
+	}
+
+	min = -max;
+}
+
+// Adds the time until it goes out of scope to *total in milliseconds, if any
+class ScopedTime
+{
+public:
+	explicit ScopedTime(double* total)
+	        : mTotal(total)
+	{
+		if(mTotal)
+			mStart = Timer::ClockType::now();
+	}
+
+	~ScopedTime()
+	{
+		if(mTotal)
+			*mTotal +=
+			        Timer::MilliSecondType(Timer::ClockType::now() - mStart).count();
+	}
+
+private:
+	double*              mTotal;
+	Timer::TimepointType mStart;
+};
+
+// Frame centered on the segment with x along it
+static Transform GetSegmentSpace(vec2 a, vec2 b, float& half_length)
+{
+	vec2  d      = b - a;
+	float length = d.Length();
+	float c      = length > 0.0f ? d.x / length : 1.0f;
+	float s      = length > 0.0f ? d.y / length : 0.0f;
+
+	half_length = 0.5f * length;
+	return Transform(c, -s, 0.5f * (a.x + b.x), s, c, 0.5f * (a.y + b.y));
+}
+
+Renderer::Renderer(RenderDevicePtr& device, const RendererSettings& settings)
         : mDevice {*device},
           mColor {Color::WHITE},
+          mLayer {},
+          mDepth {},
+          mBlendMode {BlendMode::Alpha},
           mStats {},
-          mMaxQuads {max_quads},
-          mMaxVertices {mMaxQuads * 4},
-          mMaxIndices {mMaxQuads * 6},
-          mTextureIndex {},
-          mQuadVertices {mMaxVertices},
+          mHistory(std::max(settings.StatsHistory, 1u)),
+          mHistoryIndex {},
+          mHistoryCount {},
+          mTimeSubmission {settings.TimeSubmission},
+          mThread {nullptr},
+          mFrame {&mFrames[0]},
+          mDrawnFrame {&mFrames[0]},
+          mPass {nullptr},
+          mBatchType {PrimitiveType::Quad},
+          mAppliedBlend {BlendMode::Alpha},
+          mCachedLayer {nullptr},
+          mMode {settings.Mode},
+          mMultiDraw {settings.MultiDraw && mMode != BatchMode::Pulling},
+          mCompact {settings.CompactVertices && mMode == BatchMode::Vertex},
+          mMinCapacity {std::max(settings.MaxQuads, 1u)},
+          mMaxCapacity {std::max(settings.MaxQuadsLimit, mMinCapacity)},
+          mShrinkFrames {settings.ShrinkFrames},
+          mQuadCapacity {mMinCapacity, 0, 0},
+          mShapeCapacity {mMinCapacity, 0, 0},
+          mIndirectCommands {nullptr},
+          mIndirectCount {},
+          mArraySlotCount {std::min(
+                  QuadArraySlots,
+                  std::max(device->GetInfo().NumTextureUnits / 8, 1u))},
+          mTextureSlotCount {
+                  std::min(QuadTextureSlots,
+                           std::max(device->GetInfo().NumTextureUnits, 2u) -
+                                   mArraySlotCount)},
+          mTextureSlots {mTextureSlotCount, mArraySlotCount},
+          mTextureCount {},
+          mFrameRecords {nullptr},
+          mFrameRecord {},
+          mFrameTime {},
+          mQuadVertices {nullptr},
+          mQuadCompactVertices {nullptr},
+          mQuadInstances {nullptr},
           mQuadCount {},
-          mCircleVertices {mMaxVertices},
-          mCircleCount {}
+          mQuadRoom {},
+          mShapeVertices {nullptr},
+          mShapeCompactVertices {nullptr},
+          mShapeInstances {nullptr},
+          mShapeCount {},
+          mShapeRoom {},
+          mShadersReady {settings.WaitForShaders}
 {
 	TRACE("Renderer initializing...");
 
+	// the variants of the batch shaders
+	StringArray defines;
+	switch(mMode)
+	{
+	case BatchMode::Vertex: break;
+	case BatchMode::Instanced: defines.push_back("INSTANCED"); break;
+	case BatchMode::Pulling: defines.push_back("PULLING"); break;
+	}
+
+	// samplers of the quad shaders, only defined when the device has fewer units
+	// than the shaders declare by default so precompiled modules still match
+	StringArray slots;
+	if(mTextureSlotCount != QuadTextureSlots || mArraySlotCount != QuadArraySlots)
+	{
+		WARN("%u texture units available, quad shaders use %u 2D and %u array slots",
+		     mDevice.GetInfo().NumTextureUnits,
+		     mTextureSlotCount,
+		     mArraySlotCount);
+		slots.push_back("TEXTURE_SLOTS=" + std::to_string(mTextureSlotCount));
+		slots.push_back("ARRAY_SLOTS=" + std::to_string(mArraySlotCount));
+	}
+	StringArray quad_defines = defines;
+	quad_defines.insert(quad_defines.end(), slots.begin(), slots.end());
+
+	// specialization constants of the shape shader
+	u32 edge_width = 0;
+	std::memcpy(&edge_width, &settings.ShapeEdgeWidth, sizeof(edge_width));
+
+	// they compile while the application starts, frames are skipped until they are
+	// done (see RendererSettings::WaitForShaders).
+	// Static batches have vertices in every mode, in BatchMode::Vertex the static
+	// shader is the quad shader again.
+	Vector<ShaderPtr> shaders =
+	        Shader::Create({{"shaders/QuadShader.glsl", quad_defines, {}},
+	                        {"shaders/ShapeShader.glsl", defines, {{0, edge_width}}},
+	                        {"shaders/QuadShader.glsl", slots, {}}});
+
+	mQuadShader   = shaders[0];
+	mShapeShader  = shaders[1];
+	mStaticShader = shaders[2];
+
+	CreateBuffers();
+
+	// a frame with more passes than that moves on to the next region early
+	mFrameUniforms = UniformBuffer::Create(sizeof(FrameUniforms), 16);
+	mFrameRecords  = static_cast<u8*>(mFrameUniforms->Map());
+
+	if(settings.GPUTiming)
+		mProfiler = MakeUnique<GPUProfiler>();
+
+	if(settings.CompactVertices && !mCompact)
+		WARN("Compact vertices are only used by BatchMode::Vertex");
+
+	if(mMultiDraw)
+	{
+		// a multi draw has at most StreamRegionCount commands, a region holds
+		// a good number of them before the ring moves on
+		mIndirectBuffer   = IndirectBuffer::Create(256);
+		mIndirectCommands = mIndirectBuffer->Map();
+		mQuadDraws.reserve(StreamRegionCount);
+		mShapeDraws.reserve(StreamRegionCount);
+	}
+
+	OpenPass(Transform(), nullptr);
+
+	mWhiteTexture = Texture::Create();
+	ResetTextureSlots();
+	ApplyBlendMode(mAppliedBlend);
+
+	TRACE("Renderer initialized");
+}
+
+Renderer::~Renderer()
+{
+	TRACE("Renderer destroying...");
+
+	// queued frames point back to the renderer
+	Sync();
+
+	TRACE("Renderer destroyed");
+}
+
+void Renderer::DrawBegin(const Transform& view_projection)
+{
+	mPass->ViewProjection = view_projection;
+	mFrame->Skipped       = !AreShadersReady();
+
+	if(!mThread)
+		BeginFrame();
+}
+
+void Renderer::DrawEnd()
+{
+	if(!mThread)
+	{
+		Flush();
+		EndFrame();
+		RecordStats(mFrame->Stats);
+		mFrame->Stats = {};
+		return;
+	}
+
+	Transform      view_projection = mPass->ViewProjection;
+	FramebufferPtr target          = mPass->Target;
+
+	// what the frame uses may have been created or changed on this thread, the
+	// render thread's commands wait on the GPU until that is done
+	GPUFence fence = mDevice.CreateFence();
+
+	RenderFrame* frame = mFrame;
+	frame->Ticket      = mThread->Submit([this, frame, fence]
+	                                     {
+	                                             mDevice.WaitFence(fence);
+	                                             DrawFrame(*frame);
+	                                     });
+
+	// the previous DrawEnd submitted the other frame, it is recorded again once
+	// the render thread is done with it
+	mFrame = frame == &mFrames[0] ? &mFrames[1] : &mFrames[0];
+	if(mFrame->Ticket != 0)
+	{
+		mThread->Wait(mFrame->Ticket);
+		RecordStats(mFrame->Stats);
+	}
+
+	ResetFrame(*mFrame);
+	mFrame->Stats = {};
+	OpenPass(view_projection, std::move(target));
+}
+
+void Renderer::Flush()
+{
+	Transform      view_projection = mPass->ViewProjection;
+	FramebufferPtr target          = mPass->Target;
+
+	if(mThread)
+	{
+		if(!mPass->IsEmpty())
+			OpenPass(view_projection, std::move(target));
+		return;
+	}
+
+	DrawPasses();
+	ResetFrame(*mFrame);
+	OpenPass(view_projection, std::move(target));
+}
+
+void Renderer::Clear()
+{
+	// a pass clears before its draws
+	if(!mPass->Queue.IsEmpty())
+		Flush();
+
+	mPass->Clear = true;
+}
+
+void Renderer::SetRenderThread(RenderThread* thread)
+{
+	Sync();
+
+	mThread     = thread;
+	mDrawnFrame = mFrame;
+}
+
+void Renderer::Sync()
+{
+	if(!mThread)
+		return;
+
+	mThread->Wait();
+
+	// submitted by the last DrawEnd
+	RenderFrame& previous = mFrame == &mFrames[0] ? mFrames[1] : mFrames[0];
+	if(previous.Ticket != 0)
+	{
+		RecordStats(previous.Stats);
+		ResetFrame(previous);
+	}
+}
+
+Renderer::RenderPass& Renderer::OpenPass(const Transform& view_projection,
+                                         FramebufferPtr   target)
+{
+	RenderFrame& frame = *mFrame;
+	if(frame.PassCount == frame.Passes.size())
+	{
+		frame.Passes.push_back(MakeUnique<RenderPass>());
+
+		// most frames have a single pass
+		if(frame.PassCount == 0)
+			frame.Passes.back()->Queue.Reserve(mMinCapacity);
+	}
+
+	RenderPass& pass    = *frame.Passes[frame.PassCount++];
+	pass.Stamp          = ++sPassStamp;
+	pass.ViewProjection = view_projection;
+	pass.Target         = std::move(target);
+	pass.ClearTarget    = false;
+	pass.Clear          = false;
+
+	mPass = &pass;
+	return pass;
+}
+
+void Renderer::ResetFrame(RenderFrame& frame)
+{
+	// drops what the passes referenced as well
+	for(u32 i = 0; i < frame.PassCount; ++i)
+	{
+		RenderPass& pass = *frame.Passes[i];
+		pass.Queue.Clear();
+		pass.Textures.clear();
+		pass.StaticBatches.clear();
+		pass.StaticTextures.clear();
+		pass.StaticChanges.clear();
+		pass.Target.reset();
+	}
+
+	frame.PassCount = 0;
+	frame.Ticket    = 0;
+}
+
+void Renderer::RecordStats(const FrameStats& stats)
+{
+	mStats = stats;
+
+	mHistory[mHistoryIndex] = mStats;
+	mHistoryIndex           = (mHistoryIndex + 1) % u32(mHistory.size());
+	mHistoryCount           = std::min(mHistoryCount + 1, u32(mHistory.size()));
+}
+
+void Renderer::DrawFrame(RenderFrame& frame)
+{
+	mDrawnFrame = &frame;
+
+	BeginFrame();
+	DrawPasses();
+	EndFrame();
+}
+
+void Renderer::BeginFrame()
+{
+	mQuadCount  = 0;
+	mShapeCount = 0;
+	ResetTextureSlots();
+	mFrameTime = float(mClock.Seconds());
+
+	if(mProfiler)
+		mProfiler->BeginFrame();
+}
+
+void Renderer::EndFrame()
+{
+	if(mProfiler)
+	{
+		mProfiler->EndFrame();
+		mDrawnFrame->Stats.GPUTime = mProfiler->GetFrameTime();
+	}
+
+	mFrameUniforms->Unmap();
+	mFrameRecords = static_cast<u8*>(mFrameUniforms->Map());
+	mFrameRecord  = 0;
+
+	// both first, the index buffer is shared
+	bool quads  = AdaptCapacity(mQuadCapacity);
+	bool shapes = AdaptCapacity(mShapeCapacity);
+	if(quads || shapes)
+	{
+		TRACE("Batch capacity changed to %u quads, %u shapes",
+		      mQuadCapacity.Size,
+		      mShapeCapacity.Size);
+		CreateBuffers();
+	}
+}
+
+bool Renderer::AdaptCapacity(BatchCapacity& capacity)
+{
+	u32 size = capacity.Size;
+
+	if(capacity.Used > size)
+	{
+		size                 = std::min(size * 2, mMaxCapacity);
+		capacity.QuietFrames = 0;
+	}
+	else if(mShrinkFrames != 0 && capacity.Used < size / 4 && size > mMinCapacity)
+	{
+		if(++capacity.QuietFrames >= mShrinkFrames)
+		{
+			size                 = std::max(size / 2, mMinCapacity);
+			capacity.QuietFrames = 0;
+		}
+	}
+	else
+		capacity.QuietFrames = 0;
+
+	capacity.Used = 0;
+
+	bool changed  = size != capacity.Size;
+	capacity.Size = size;
+	return changed;
+}
+
+void Renderer::CreateBuffers()
+{
+	const u32 quads  = mQuadCapacity.Size;
+	const u32 shapes = mShapeCapacity.Size;
+
+	// vertex mode indexes four vertices per primitive, instancing repeats one
+	// quad and pulling needs no indices at all
+	u32 index_count = 0;
+	if(mMode == BatchMode::Vertex)
+		index_count = std::max(quads, shapes) * 6;
+	else if(mMode == BatchMode::Instanced)
+		index_count = 6;
+
+	mIB.reset();
+	if(index_count != 0)
 	{  // Create index buffer and upload to GPU
-		Vector<u32> indices(mMaxIndices);
-		for(u32 offset = 0, i = 0; i < mMaxIndices; i += 6, offset += 4)
+		Vector<u32> indices(index_count);
+		for(u32 offset = 0, i = 0; i < index_count; i += 6, offset += 4)
 		{
 			indices[i]     = offset;
 			indices[i + 1] = offset + 1;
@@ -30,150 +507,755 @@ Renderer::Renderer(RenderDevicePtr& device, u32 max_quads)
 			indices[i + 5] = offset;
 		}
 
-		mIB = IndexBuffer::Create(indices.data(), mMaxIndices);
+		mIB = IndexBuffer::Create(indices.data(), index_count);
+	}
+
+	if(mMode == BatchMode::Instanced)
+	{
+		// A single quad of indices, gl_VertexID picks the corner.
+		mQuadVB = VertexBuffer::Create({Vertex {VertexType::Float3},
+		                                Vertex {VertexType::Float3},
+		                                Vertex {VertexType::Float4},
+		                                Vertex {VertexType::UByte4, true},
+		                                Vertex {VertexType::Float},
+		                                Vertex {VertexType::Float}},
+		                               quads,
+		                               sizeof(QuadInstance),
+		                               BufferUsage::Stream);
+
+		mQuadVA = VertexArray::Create();
+		mQuadVA->AttachIndexBuffer(mIB);
+		mQuadVA->AttachVertexBuffer(mQuadVB, 1);
+
+		mShapeVB = VertexBuffer::Create({Vertex {VertexType::Float3},
+		                                 Vertex {VertexType::Float3},
+		                                 Vertex {VertexType::Float4},
+		                                 Vertex {VertexType::UByte4, true},
+		                                 Vertex {VertexType::Float4},
+		                                 Vertex {VertexType::Float},
+		                                 Vertex {VertexType::Float},
+		                                 Vertex {VertexType::Float}},
+		                                shapes,
+		                                sizeof(ShapeInstance),
+		                                BufferUsage::Stream);
+
+		mShapeVA = VertexArray::Create();
+		mShapeVA->AttachIndexBuffer(mIB);
+		mShapeVA->AttachVertexBuffer(mShapeVB, 1);
 	}
+	else if(mMode == BatchMode::Pulling)
+	{
+		// Instance records without attributes or indices. The shaders read them
+		// from the buffers bound as storage, gl_VertexID / 6 is the record.
+		mQuadVB = VertexBuffer::Create(
+		        {}, quads, sizeof(QuadInstance), BufferUsage::Stream);
+		mShapeVB = VertexBuffer::Create(
+		        {}, shapes, sizeof(ShapeInstance), BufferUsage::Stream);
 
-	mQuadVB = VertexBuffer::Create({Vertex {VertexType::Float2},
-	                                Vertex {VertexType::Float2},
-	                                Vertex {VertexType::UByte4, true},
-	                                Vertex {VertexType::Float}},
-	                               mMaxVertices,
-	                               sizeof(QuadVertex));
+		mQuadVA  = VertexArray::Create();
+		mShapeVA = mQuadVA;
+	}
+	else if(mCompact)
+	{
+		// same shaders, the attributes arrive as floats whatever their storage
+		mQuadVB = VertexBuffer::Create({Vertex {VertexType::Float2},
+		                                Vertex {VertexType::UShort2, true},
+		                                Vertex {VertexType::UByte4, true},
+		                                Vertex {VertexType::Half},
+		                                Vertex {VertexType::Half}},
+		                               quads * 4,
+		                               sizeof(QuadVertexCompact),
+		                               BufferUsage::Stream);
 
-	mQuadVA = VertexArray::Create();
-	mQuadVA->AttachIndexBuffer(mIB);
-	mQuadVA->AttachVertexBuffer(mQuadVB);
-	mQuadShader = Shader::Create("shaders/QuadShader.glsl");
+		mQuadVA = VertexArray::Create();
+		mQuadVA->AttachIndexBuffer(mIB);
+		mQuadVA->AttachVertexBuffer(mQuadVB);
 
-	mCircleVB = VertexBuffer::Create({Vertex {VertexType::Float2},
-	                                  Vertex {VertexType::Float2},
-	                                  Vertex {VertexType::UByte4, true},
-	                                  Vertex {VertexType::Float},
-	                                  Vertex {VertexType::Float}},
-	                                 mMaxVertices,
-	                                 sizeof(CircleVertex));
+		mShapeVB = VertexBuffer::Create({Vertex {VertexType::Float2},
+		                                 Vertex {VertexType::Half2},
+		                                 Vertex {VertexType::UByte4, true},
+		                                 Vertex {VertexType::Half4},
+		                                 Vertex {VertexType::Half},
+		                                 Vertex {VertexType::Half},
+		                                 Vertex {VertexType::Half}},
+		                                shapes * 4,
+		                                sizeof(ShapeVertexCompact),
+		                                BufferUsage::Stream);
 
-	mCircleVA = VertexArray::Create();
-	mCircleVA->AttachIndexBuffer(mIB);
-	mCircleVA->AttachVertexBuffer(mCircleVB);
-	mCircleShader = Shader::Create("shaders/CircleShader.glsl");
+		mShapeVA = VertexArray::Create();
+		mShapeVA->AttachIndexBuffer(mIB);
+		mShapeVA->AttachVertexBuffer(mShapeVB);
+	}
+	else
+	{
+		mQuadVB = VertexBuffer::Create({Vertex {VertexType::Float2},
+		                                Vertex {VertexType::Float2},
+		                                Vertex {VertexType::UByte4, true},
+		                                Vertex {VertexType::Float},
+		                                Vertex {VertexType::Float}},
+		                               quads * 4,
+		                               sizeof(QuadVertex),
+		                               BufferUsage::Stream);
 
-	mWhiteTexture = Texture::Create();
-	mTextures.resize(mDevice.GetInfo().NumTextureUnits);
-	mTextures[mTextureIndex++] = mWhiteTexture;
+		mQuadVA = VertexArray::Create();
+		mQuadVA->AttachIndexBuffer(mIB);
+		mQuadVA->AttachVertexBuffer(mQuadVB);
 
-	TRACE("Renderer initialized");
+		mShapeVB = VertexBuffer::Create({Vertex {VertexType::Float2},
+		                                 Vertex {VertexType::Float2},
+		                                 Vertex {VertexType::UByte4, true},
+		                                 Vertex {VertexType::Float4},
+		                                 Vertex {VertexType::Float},
+		                                 Vertex {VertexType::Float},
+		                                 Vertex {VertexType::Float}},
+		                                shapes * 4,
+		                                sizeof(ShapeVertex),
+		                                BufferUsage::Stream);
+
+		mShapeVA = VertexArray::Create();
+		mShapeVA->AttachIndexBuffer(mIB);
+		mShapeVA->AttachVertexBuffer(mShapeVB);
+	}
+
+	MapQuadBuffer();
+	MapShapeBuffer();
 }
 
-Renderer::~Renderer()
+const FrameStats& Renderer::GetStatsHistory(u32 age) const
 {
-	TRACE("Renderer destroying...");
+	ASSERT(age < mHistoryCount, "Frame is not in the stats history");
 
-	TRACE("Renderer destroyed");
+	u32 size = u32(mHistory.size());
+	return mHistory[(mHistoryIndex + size - 1 - age) % size];
 }
 
-void Renderer::DrawBegin(const Transform& view_projection)
+void Renderer::LogStatsSummary() const
 {
-	mViewProjection = view_projection;
+	if(mHistoryCount == 0)
+		return;
+
+	FrameStats total {};
+	FrameStats worst {};
+	for(u32 age = 0; age < mHistoryCount; ++age)
+	{
+		const FrameStats& f = GetStatsHistory(age);
 
-	mQuadCount    = 0;
-	mCircleCount  = 0;
-	mTextureIndex = 1;
+		total.DrawCalls       += f.DrawCalls;
+		total.Batches         += f.Batches;
+		total.VertexBytes     += f.VertexBytes;
+		total.TextureFlushes  += f.TextureFlushes;
+		total.CapacityFlushes += f.CapacityFlushes;
+		total.StateFlushes    += f.StateFlushes;
+		total.TextureBinds    += f.TextureBinds;
+		total.ShaderBinds     += f.ShaderBinds;
+		total.SubmitTime      += f.SubmitTime;
+		total.FlushTime       += f.FlushTime;
+		total.GPUTime         += f.GPUTime;
 
-	mStats.DrawCalls = 0;
-	mStats.QuadCount = 0;
+		worst.DrawCalls   = std::max(worst.DrawCalls, f.DrawCalls);
+		worst.VertexBytes = std::max(worst.VertexBytes, f.VertexBytes);
+		worst.SubmitTime  = std::max(worst.SubmitTime, f.SubmitTime);
+		worst.FlushTime   = std::max(worst.FlushTime, f.FlushTime);
+		worst.GPUTime     = std::max(worst.GPUTime, f.GPUTime);
+	}
+
+	const double n = mHistoryCount;
+	INFO("Renderer, average (worst) of the last %u frames:", mHistoryCount);
+	INFO("  draw calls %.1f (%u), batches %.1f",
+	     total.DrawCalls / n,
+	     worst.DrawCalls,
+	     total.Batches / n);
+	INFO("  flushes: texture slots %.2f, capacity %.2f, state %.2f",
+	     total.TextureFlushes / n,
+	     total.CapacityFlushes / n,
+	     total.StateFlushes / n);
+	INFO("  vertex KiB %.1f (%.1f), texture binds %.1f, shader binds %.1f",
+	     total.VertexBytes / n / 1024.0,
+	     worst.VertexBytes / 1024.0,
+	     total.TextureBinds / n,
+	     total.ShaderBinds / n);
+	INFO("  submit ms %.3f (%.3f), flush ms %.3f (%.3f), GPU ms %.3f (%.3f)",
+	     total.SubmitTime / n,
+	     worst.SubmitTime,
+	     total.FlushTime / n,
+	     worst.FlushTime,
+	     total.GPUTime / n,
+	     worst.GPUTime);
 }
 
-void Renderer::DrawEnd()
+void Renderer::DrawPasses()
 {
-	Flush();
+	RenderFrame& frame = *mDrawnFrame;
+
+	ScopedTime time(&frame.Stats.FlushTime);
+	if(mProfiler)
+		mProfiler->BeginZone("Flush");
+
+	for(u32 i = 0; i < frame.PassCount; ++i)
+	{
+		RenderPass& pass = *frame.Passes[i];
+
+		if(pass.Target != mDevice.GetRenderTarget())
+			mDevice.SetRenderTarget(pass.Target);
+		if(pass.ClearTarget)
+			pass.Target->Clear(Color::BLANK);
+		if(pass.Clear)
+			mDevice.Clear();
+
+		// skipped frames too, the batches handed their changes over
+		UploadStaticChanges(pass);
+
+		if(frame.Skipped)
+			continue;
+
+		BindFrameUniforms(pass);
+		FlushPass(pass);
+	}
+
+	// the window is the target between flushes
+	if(mDevice.GetRenderTarget())
+		mDevice.SetRenderTarget(nullptr);
+
+	if(mProfiler)
+		mProfiler->EndZone();
 }
 
-void Renderer::Flush()
+bool Renderer::AreShadersReady()
+{
+	// a shader that failed to link never is, its frames stay blank
+	if(!mShadersReady)
+		mShadersReady = mQuadShader->IsReady() && mShapeShader->IsReady() &&
+		                mStaticShader->IsReady();
+
+	return mShadersReady;
+}
+
+void Renderer::FlushPass(RenderPass& pass)
 {
+	RenderQueue& queue = pass.Queue;
+	queue.Sort();
+
+	for(u32 i = 0; i < queue.GetSize(); ++i)
+	{
+		const RenderCommand& command = queue[i];
+
+		BlendMode blend = RenderQueue::GetBlendMode(queue.GetKey(i));
+		if(blend != mAppliedBlend)
+		{
+			FlushBatch(FlushReason::State);
+			ApplyBlendMode(blend);
+		}
+
+		// a batch holds a single primitive type
+		if(command.Type != mBatchType)
+		{
+			FlushBatch(FlushReason::State);
+			mBatchType = command.Type;
+		}
+
+		switch(command.Type)
+		{
+		case PrimitiveType::Quad: EmitQuad(command); break;
+		case PrimitiveType::Shape: EmitShape(command); break;
+		case PrimitiveType::StaticBatch:
+			EmitStaticBatch(
+			        pass.StaticBatches[RenderQueue::GetTextureID(queue.GetKey(i))],
+			        pass);
+			break;
+		}
+	}
+
+	FlushBatch(FlushReason::Queue);
+}
+
+void Renderer::UploadStaticChanges(const RenderPass& pass)
+{
+	// recorded while an earlier frame may have been drawing from the buffers
+	for(const StaticDraw& draw : pass.StaticBatches)
+	{
+		if(draw.ChangeCount != 0)
+			draw.VB->SetSubData(&pass.StaticChanges[draw.FirstChange],
+			                    draw.ChangeCount,
+			                    draw.FirstVertex);
+	}
+}
+
+void Renderer::BindFrameUniforms(const RenderPass& pass)
+{
+	vec2ui size = pass.Target ? vec2ui(pass.Target->GetWidth(),
+	                                   pass.Target->GetHeight())
+	                          : mDevice.GetViewportSize();
+
+	const float*  m = pass.ViewProjection.GetPtr();
+	FrameUniforms uniforms {{{m[0], m[1], m[2], 0.0f}, {m[3], m[4], m[5], 0.0f}},
+	                        vec2(size),
+	                        mFrameTime,
+	                        0.0f};
+
+	if(mFrameRecord == mFrameUniforms->GetCount())
+	{
+		mFrameUniforms->Unmap();
+		mFrameRecords = static_cast<u8*>(mFrameUniforms->Map());
+		mFrameRecord  = 0;
+	}
+
+	std::memcpy(mFrameRecords + size_t(mFrameRecord) * mFrameUniforms->GetStride(),
+	            &uniforms,
+	            sizeof(uniforms));
+	// bound for every pass, other renderers bind their own records there too
+	mFrameUniforms->Bind(FrameUniformBinding, mFrameRecord++);
+}
+
+void Renderer::FlushBatch(FlushReason reason)
+{
+	if(mQuadCount != 0 || mShapeCount != 0)
+	{
+		switch(reason)
+		{
+		case FlushReason::Texture: ++mDrawnFrame->Stats.TextureFlushes; break;
+		case FlushReason::Capacity: ++mDrawnFrame->Stats.CapacityFlushes; break;
+		case FlushReason::State: ++mDrawnFrame->Stats.StateFlushes; break;
+		case FlushReason::Queue: ++mDrawnFrame->Stats.QueueFlushes; break;
+		}
+	}
+
 	// flush quads
 	if(mQuadCount != 0)
 	{
-		for(u32 i = 0; i < mTextureIndex; ++i)
+		mDrawnFrame->Stats.TextureBinds += mTextureSlots.Bind();
+
+		mQuadShader->Bind();
+		++mDrawnFrame->Stats.ShaderBinds;
+		if(mProfiler)
+			mProfiler->BeginZone("Quads");
+		SubmitBatch(mQuadVA, mQuadVB, mQuadDraws, mQuadCount);
+		if(mProfiler)
+			mProfiler->EndZone();
+
+		// vertices are already in place, fence them and go on behind them
+		mQuadVB->Unmap(GetRecordCount(mQuadCount));
+		MapQuadBuffer();
+
+		mQuadCount = 0;
+		ResetTextureSlots();
+	}
+
+	// flush shapes
+	if(mShapeCount != 0)
+	{
+		mShapeShader->Bind();
+		++mDrawnFrame->Stats.ShaderBinds;
+		if(mProfiler)
+			mProfiler->BeginZone("Shapes");
+		SubmitBatch(mShapeVA, mShapeVB, mShapeDraws, mShapeCount);
+		if(mProfiler)
+			mProfiler->EndZone();
+
+		mShapeVB->Unmap(GetRecordCount(mShapeCount));
+		MapShapeBuffer();
+
+		mShapeCount = 0;
+	}
+}
+
+bool Renderer::ContinueBatch(const VertexBufferPtr&      vb,
+                             Vector<DrawIndexedCommand>& draws,
+                             u32&                        count)
+{
+	// The region is full but shader, blend mode and textures stay the same, so
+	// record it and go on in the next region of the ring. It is drawn with the
+	// rest of the batch by the next SubmitBatch. It spans one region less than
+	// the ring, so the ring moves on into a region fenced before the batch was.
+	if(!mMultiDraw || draws.size() + 2 >= StreamRegionCount)
+		return false;
+
+	RecordBatch(vb, draws, count);
+	vb->Advance();
+	count = 0;
+	return true;
+}
+
+void Renderer::SubmitBatch(const VertexArrayPtr&       va,
+                           const VertexBufferPtr&      vb,
+                           Vector<DrawIndexedCommand>& draws,
+                           u32                         count)
+{
+	RecordBatch(vb, draws, count);
+
+	if(mMultiDraw)
+	{
+		auto size = u32(draws.size());
+		if(mIndirectCount + size > mIndirectBuffer->GetCount())
 		{
-			mTextures[i]->Bind(i);
+			mIndirectBuffer->Unmap();
+			mIndirectCommands = mIndirectBuffer->Map();
+			mIndirectCount    = 0;
 		}
 
-		mQuadVB->SetData(mQuadVertices.data(), mQuadCount * 4);
-		mQuadShader->Bind();
-		mQuadShader->SetTransform("uViewProjection", mViewProjection);
-		mDevice.DrawIndexed(mQuadVA, mQuadCount * 6);
-		++mStats.DrawCalls;
-		mQuadCount    = 0;
-		mTextureIndex = 1;
+		u32 first = mIndirectBuffer->GetBaseCommand() + mIndirectCount;
+		std::copy(draws.begin(), draws.end(), mIndirectCommands + mIndirectCount);
+		mDevice.DrawIndexedIndirect(va, mIndirectBuffer, first, size);
+		mIndirectCount += size;
 	}
+	else
+	{
+		const DrawIndexedCommand& draw = draws.back();
+
+		switch(mMode)
+		{
+		case BatchMode::Vertex:
+			mDevice.DrawIndexed(va, draw.IndexCount, u32(draw.BaseVertex));
+			break;
+
+		case BatchMode::Instanced:
+			mDevice.DrawIndexedInstanced(
+			        va, draw.IndexCount, draw.InstanceCount, draw.BaseInstance);
+			break;
+
+		case BatchMode::Pulling:
+			// six vertices per record, from the first record of the region
+			vb->BindStorage(0);
+			mDevice.Draw(va, draw.IndexCount, u32(draw.BaseVertex) * 6);
+			break;
+		}
+	}
+
+	draws.clear();
+	++mDrawnFrame->Stats.DrawCalls;
+}
+
+void Renderer::RecordBatch(const VertexBufferPtr&      vb,
+                           Vector<DrawIndexedCommand>& draws,
+                           u32                         count)
+{
+	draws.push_back(MakeDraw(count, vb->GetBaseVertex()));
+
+	mDrawnFrame->Stats.VertexBytes += GetRecordCount(count) * vb->GetStride();
+	++mDrawnFrame->Stats.Batches;
+}
+
+DrawIndexedCommand Renderer::MakeDraw(u32 count, u32 base) const
+{
+	// base is where the region starts, in vertices or in records
+	if(mMode == BatchMode::Instanced)
+		return {6, count, 0, 0, base};
+	else
+		return {count * 6, 1, 0, i32(base), 0};
+}
 
-	// flush circles
-	if(mCircleCount != 0)
+u32 Renderer::GetRecordCount(u32 count) const
+{
+	// four vertices per primitive, or a single instance
+	return mMode == BatchMode::Vertex ? count * 4 : count;
+}
+
+void Renderer::MapQuadBuffer()
+{
+	void* region         = mQuadVB->Map();
+	mQuadRoom            = mQuadVB->GetRoom() / GetRecordCount(1);
+	mQuadVertices        = static_cast<QuadVertex*>(region);
+	mQuadCompactVertices = static_cast<QuadVertexCompact*>(region);
+	mQuadInstances       = static_cast<QuadInstance*>(region);
+}
+
+void Renderer::MapShapeBuffer()
+{
+	void* region          = mShapeVB->Map();
+	mShapeRoom            = mShapeVB->GetRoom() / GetRecordCount(1);
+	mShapeVertices        = static_cast<ShapeVertex*>(region);
+	mShapeCompactVertices = static_cast<ShapeVertexCompact*>(region);
+	mShapeInstances       = static_cast<ShapeInstance*>(region);
+}
+
+void Renderer::ApplyBlendMode(BlendMode mode)
+{
+	switch(mode)
 	{
-		mCircleVB->SetData(mCircleVertices.data(), mCircleCount * 4);
-		mCircleShader->Bind();
-		mCircleShader->SetTransform("uViewProjection", mViewProjection);
-		mDevice.DrawIndexed(mCircleVA, mCircleCount * 6);
-		++mStats.DrawCalls;
-		mCircleCount = 0;
+	// Alpha is accumulated like premultiplied color, so what is drawn into an
+	// empty render target can be composited with BlendMode::Premultiplied
+	case BlendMode::Alpha:
+		mDevice.SetBlendFuncSeparate(BlendFunc::SrcAlpha,
+		                             BlendFunc::OneMinusSrcAlpha,
+		                             BlendFunc::One,
+		                             BlendFunc::OneMinusSrcAlpha,
+		                             Color::WHITE);
+		break;
+
+	case BlendMode::Additive:
+		mDevice.SetBlendFuncSeparate(BlendFunc::SrcAlpha,
+		                             BlendFunc::One,
+		                             BlendFunc::One,
+		                             BlendFunc::One,
+		                             Color::WHITE);
+		break;
+
+	case BlendMode::Premultiplied:
+		mDevice.SetBlendFunc(
+		        BlendFunc::One, BlendFunc::OneMinusSrcAlpha, Color::WHITE);
+		break;
 	}
+
+	mAppliedBlend = mode;
 }
 
-void Renderer::DrawQuad(const TexturePtr& texture,
-                        const Transform&  model,
-                        const vec2*       uv)
+void Renderer::ResetTextureSlots()
+{
+	// slot 0 always holds the white texture
+	u32 slot = 0;
+	mTextureSlots.Reset();
+	mTextureSlots.Acquire(mWhiteTexture.get(), slot);
+}
+
+u64 Renderer::MakeKey(PrimitiveType type, Texture* texture)
 {
-	if(mQuadCount >= mMaxQuads)
+	u32 id = texture ? GetRenderID(texture) : 0;
+	return RenderQueue::MakeKey(mLayer, GetDepthKey(), mBlendMode, type, id);
+}
+
+u16 Renderer::GetDepthKey() const
+{
+	// greater depth sorts first
+	return u16(0xffff - u16(std::clamp(mDepth, 0.0f, 1.0f) * 65535.0f));
+}
+
+u32 Renderer::GetRenderID(Texture* texture)
+{
+	if(texture->mRenderID == 0)
+		texture->mRenderID = ++mTextureCount;
+	return texture->mRenderID;
+}
+
+void Renderer::HoldTexture(const TexturePtr& texture)
+{
+	// the pass may be drawn after the caller let go of the texture, by the render
+	// thread; once per pass is enough
+	if(texture->mPassStamp != mPass->Stamp)
 	{
-		Flush();
+		texture->mPassStamp = mPass->Stamp;
+		mPass->Textures.push_back(texture);
+	}
+}
+
+void Renderer::EmitQuad(const RenderCommand& command)
+{
+	if(mQuadCount == mQuadRoom)
+	{
+		// the next region starts empty, a texture that does not fit then could
+		// not flush the recorded regions (FlushBatch needs quads to submit)
+		if(!mTextureSlots.IsFull() &&
+		   ContinueBatch(mQuadVB, mQuadDraws, mQuadCount))
+			MapQuadBuffer();
+		else
+			FlushBatch(FlushReason::Capacity);
 	}
+	++mQuadCapacity.Used;
 
+	Texture* texture = command.Texture;
+
+	// texture slots are full. so, Flush!
 	u32 index = 0;
-	while(index < mTextureIndex)
+	if(!mTextureSlots.Acquire(texture, index))
+	{
+		FlushBatch(FlushReason::Texture);
+		bool acquired = mTextureSlots.Acquire(texture, index);
+		ASSERT(acquired, "No texture slot after the batch was flushed");
+		(void)acquired;
+	}
+
+	float layer = static_cast<float>(command.ArrayLayer);
+
+	// instanced and pulling modes share the record layout
+	if(mMode != BatchMode::Vertex)
+	{
+		QuadInstance& q = mQuadInstances[mQuadCount];
+
+		q.Model      = command.Model;
+		q.UVMin      = command.UVMin;
+		q.UVMax      = command.UVMax;
+		q.Color      = command.Color;
+		q.TexID      = static_cast<float>(index);
+		q.ArrayLayer = layer;
+
+		++mQuadCount;
+		return;
+	}
+
+	const Transform& model = command.Model;
+
+	vec2 uv[4] = {command.UVMin,
+	              {command.UVMax.x, command.UVMin.y},
+	              command.UVMax,
+	              {command.UVMin.x, command.UVMax.y}};
+
+	u32 i = mQuadCount * 4;
+
+	alignas(16) float px[4];
+	alignas(16) float py[4];
+
+#if ENGINE_CPU_X86_64
+	// all four corners at once: x = m0 * cx + m1 * cy + m2
+	const float* m  = model.GetPtr();
+	const __m128 cx = _mm_setr_ps(-0.5f, 0.5f, 0.5f, -0.5f);
+	const __m128 cy = _mm_setr_ps(-0.5f, -0.5f, 0.5f, 0.5f);
+
+	_mm_store_ps(px,
+	             _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0]), cx),
+	                                   _mm_mul_ps(_mm_set1_ps(m[1]), cy)),
+	                        _mm_set1_ps(m[2])));
+	_mm_store_ps(py,
+	             _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[3]), cx),
+	                                   _mm_mul_ps(_mm_set1_ps(m[4]), cy)),
+	                        _mm_set1_ps(m[5])));
+#else
+	for(u32 c = 0; c < 4; ++c)
+	{
+		vec2 p = model * mQuadPositions[c];
+		px[c]  = p.x;
+		py[c]  = p.y;
+	}
+#endif
+
+	if(mCompact)
 	{
-		if(*texture == *mTextures[index++])
+		u16 slot        = FloatToHalf(static_cast<float>(index));
+		u16 array_layer = FloatToHalf(layer);
+
+		for(u32 c = 0; c < 4; ++c, ++i)
 		{
-			break;  // texture does found!
+			QuadVertexCompact& v = mQuadCompactVertices[i];
+
+			v.Position   = {px[c], py[c]};
+			v.UV[0]      = ToUNorm16(uv[c].x);
+			v.UV[1]      = ToUNorm16(uv[c].y);
+			v.Color      = command.Color;
+			v.TexID      = slot;
+			v.ArrayLayer = array_layer;
 		}
+
+		++mQuadCount;
+		return;
 	}
-	// texture does not found!
-	if(index == mTextureIndex)
+
+	for(u32 c = 0; c < 4; ++c, ++i)
+	{
+		mQuadVertices[i].Position   = {px[c], py[c]};
+		mQuadVertices[i].UV         = uv[c];
+		mQuadVertices[i].Color      = command.Color;
+		mQuadVertices[i].TexID      = static_cast<float>(index);
+		mQuadVertices[i].ArrayLayer = layer;
+	}
+
+	++mQuadCount;
+}
+
+void Renderer::EmitShape(const RenderCommand& command)
+{
+	if(mShapeCount == mShapeRoom)
 	{
-		// texture slots are full. so, Flush!
-		if(mTextureIndex == mDevice.GetInfo().NumTextureUnits)
+		if(ContinueBatch(mShapeVB, mShapeDraws, mShapeCount))
+			MapShapeBuffer();
+		else
+			FlushBatch(FlushReason::Capacity);
+	}
+	++mShapeCapacity.Used;
+
+	vec2 min, max;
+	GetShapeBounds(command, min, max);
+
+	const float type = static_cast<float>(command.Shape);
+
+	if(mMode != BatchMode::Vertex)
+	{
+		ShapeInstance& s = mShapeInstances[mShapeCount];
+
+		s.Model      = command.Model;
+		s.BoundsMin  = min;
+		s.BoundsMax  = max;
+		s.Color      = command.Color;
+		s.Thickness  = command.Thickness;
+		s.Smoothness = command.Smoothness;
+		s.Type       = type;
+		std::copy_n(command.Params, 4, s.Params);
+
+		++mShapeCount;
+		return;
+	}
+
+	const vec2 local[4] = {min, {max.x, min.y}, max, {min.x, max.y}};
+
+	u32 i = mShapeCount * 4;
+
+	if(mCompact)
+	{
+		u16 params[4];
+		for(u32 p = 0; p < 4; ++p)
+			params[p] = FloatToHalf(command.Params[p]);
+
+		u16 thickness  = FloatToHalf(command.Thickness);
+		u16 smoothness = FloatToHalf(command.Smoothness);
+		u16 shape      = FloatToHalf(type);
+
+		for(u32 c = 0; c < 4; ++c, ++i)
 		{
-			Flush();
+			ShapeVertexCompact& v = mShapeCompactVertices[i];
+
+			v.WorldPosition    = command.Model * local[c];
+			v.LocalPosition[0] = FloatToHalf(local[c].x);
+			v.LocalPosition[1] = FloatToHalf(local[c].y);
+			v.Color            = command.Color;
+			v.Thickness        = thickness;
+			v.Smoothness       = smoothness;
+			v.Type             = shape;
+			std::copy_n(params, 4, v.Params);
 		}
-		// now add new texture.
-		index                      = mTextureIndex;
-		mTextures[mTextureIndex++] = texture;
+
+		++mShapeCount;
+		return;
 	}
 
-	u32 i = mQuadCount * 4;
+	for(u32 c = 0; c < 4; ++c, ++i)
+	{
+		ShapeVertex& v = mShapeVertices[i];
 
-	mQuadVertices[i].Position = model * mQuadPositions[0];
-	mQuadVertices[i].UV       = uv[0];
-	mQuadVertices[i].Color    = mColor;
-	mQuadVertices[i++].TexID  = static_cast<float>(index);
+		v.WorldPosition = command.Model * local[c];
+		v.LocalPosition = local[c];
+		v.Color         = command.Color;
+		v.Thickness     = command.Thickness;
+		v.Smoothness    = command.Smoothness;
+		v.Type          = type;
+		std::copy_n(command.Params, 4, v.Params);
+	}
 
-	mQuadVertices[i].Position = model * mQuadPositions[1];
-	mQuadVertices[i].UV       = uv[1];
-	mQuadVertices[i].Color    = mColor;
-	mQuadVertices[i++].TexID  = static_cast<float>(index);
+	++mShapeCount;
+}
 
-	mQuadVertices[i].Position = model * mQuadPositions[2];
-	mQuadVertices[i].UV       = uv[2];
-	mQuadVertices[i].Color    = mColor;
-	mQuadVertices[i++].TexID  = static_cast<float>(index);
+void Renderer::DrawQuad(const TexturePtr& texture,
+                        const Transform&  model,
+                        const vec2*       uv)
+{
+	// the queue keeps an axis aligned uv rectangle, uv[0] and uv[2] are opposite
+	// corners
+	SubmitQuad(texture, model, uv[0], uv[2]);
+}
 
-	mQuadVertices[i].Position = model * mQuadPositions[3];
-	mQuadVertices[i].UV       = uv[3];
-	mQuadVertices[i].Color    = mColor;
-	mQuadVertices[i].TexID    = static_cast<float>(index);
+void Renderer::DrawQuad(const SubTexture& sprite, const Transform& model)
+{
+	SubmitQuad(sprite.Texture,
+	           model,
+	           sprite.UVMin,
+	           sprite.UVMax,
+	           sprite.ArrayLayer);
+}
 
-	++mQuadCount;
-	++mStats.QuadCount;
+void Renderer::DrawQuad(const SubTexture& sprite, vec2 position, vec2 size)
+{
+	Transform model;
+	model.Translate(position).Scale(size);
+	SubmitQuad(sprite.Texture,
+	           model,
+	           sprite.UVMin,
+	           sprite.UVMax,
+	           sprite.ArrayLayer);
 }
 
 void Renderer::DrawQuad(const TexturePtr& texture, vec2 position, vec2 size)
@@ -215,6 +1297,20 @@ void Renderer::DrawRotatedQuad(const TexturePtr& texture,
 	DrawQuad(texture, model, mTextureUV);
 }
 
+void Renderer::DrawRotatedQuad(const SubTexture& sprite,
+                               vec2              position,
+                               vec2              size,
+                               float             rotation)
+{
+	Transform model;
+	model.Translate(position).Rotate(rotation).Scale(size);
+	SubmitQuad(sprite.Texture,
+	           model,
+	           sprite.UVMin,
+	           sprite.UVMax,
+	           sprite.ArrayLayer);
+}
+
 void Renderer::DrawRotatedQuad(vec2 position, vec2 size, float rotation, vec2 origin)
 {
 	Transform model;
@@ -233,45 +1329,321 @@ void Renderer::DrawRotatedQuad(vec2 position, vec2 size, float rotation)
 	DrawQuad(mWhiteTexture, model, mTextureUV);
 }
 
+void Renderer::EmitStaticBatch(const StaticDraw& draw, const RenderPass& pass)
+{
+	FrameStats& stats = mDrawnFrame->Stats;
+
+	for(u32 i = 0; i < draw.TextureCount; ++i)
+	{
+		if(Texture* texture = pass.StaticTextures[draw.FirstTexture + i].get())
+		{
+			texture->Bind(i);
+			++stats.TextureBinds;
+		}
+	}
+
+	mStaticShader->Bind();
+	++stats.ShaderBinds;
+	if(mProfiler)
+		mProfiler->BeginZone("Static");
+	mDevice.DrawIndexed(draw.VA, draw.QuadCount * 6);
+	if(mProfiler)
+		mProfiler->EndZone();
+
+	++stats.DrawCalls;
+	++stats.Batches;
+}
+
+void Renderer::DrawStaticBatch(StaticBatch& batch)
+{
+	ScopedTime time(mTimeSubmission ? &mFrame->Stats.SubmitTime : nullptr);
+
+	if(batch.GetSpriteCount() == 0)
+		return;
+
+	// the batch may change before the pass is drawn, keep what the draw needs.
+	// Its changes are uploaded with the draw, a render thread may still be drawing
+	// an earlier frame from the buffer.
+	Vector<QuadVertex>& changes = mPass->StaticChanges;
+
+	auto first_change = u32(changes.size());
+	u32  first_vertex = batch.TakeChanges(changes);
+	auto change_count = u32(changes.size()) - first_change;
+	mFrame->Stats.VertexBytes += change_count * u32(sizeof(QuadVertex));
+
+	const Vector<TexturePtr>& textures = batch.GetTextures();
+
+	auto index = u32(mPass->StaticBatches.size());
+	mPass->StaticBatches.push_back({batch.GetVertexArray(),
+	                                batch.GetVertexBuffer(),
+	                                batch.GetQuadCount(),
+	                                u32(mPass->StaticTextures.size()),
+	                                u32(textures.size()),
+	                                first_vertex,
+	                                first_change,
+	                                change_count});
+	mPass->StaticTextures.insert(
+	        mPass->StaticTextures.end(), textures.begin(), textures.end());
+
+	u64 key = RenderQueue::MakeKey(batch.GetLayer(),
+	                               GetDepthKey(),
+	                               mBlendMode,
+	                               PrimitiveType::StaticBatch,
+	                               index);
+	mPass->Queue.Push(key).Type = PrimitiveType::StaticBatch;
+
+	mFrame->Stats.QuadCount += batch.GetSpriteCount();
+}
+
+void Renderer::BeginCachedLayer(CachedLayer& layer, const Transform& view_projection)
+{
+	ASSERT(!mCachedLayer, "Cached layers can't nest");
+
+	Flush();
+
+	mCachedLayer          = &layer;
+	mFrameViewProjection  = mPass->ViewProjection;
+	layer.mViewProjection = view_projection;
+
+	mPass->ViewProjection = view_projection;
+	mPass->Target         = layer.mFramebuffer;
+	mPass->ClearTarget    = true;
+}
+
+void Renderer::EndCachedLayer()
+{
+	ASSERT(mCachedLayer, "No cached layer begun");
+
+	Flush();
+
+	mPass->ViewProjection = mFrameViewProjection;
+	mPass->Target         = nullptr;
+	mCachedLayer->mValid  = !mFrame->Skipped;
+	mCachedLayer          = nullptr;
+}
+
+void Renderer::DrawCachedLayer(const CachedLayer& layer)
+{
+	// a skipped frame could not render it and draws nothing anyway
+	if(mFrame->Skipped && !layer.IsValid())
+		return;
+
+	ASSERT(layer.IsValid(), "Cached layer drawn before it was rendered");
+
+	const TexturePtr& color   = layer.mFramebuffer->GetColorAttachment(0);
+	Texture*          texture = color.get();
+	HoldTexture(color);
+
+	u64 key = RenderQueue::MakeKey(layer.GetLayer(),
+	                               GetDepthKey(),
+	                               BlendMode::Premultiplied,
+	                               PrimitiveType::Quad,
+	                               GetRenderID(texture));
+
+	RenderCommand& command = mPass->Queue.Push(key);
+
+	// the quad's corners map to the corners of the clip space the layer was
+	// rendered in, so texels land where they were drawn
+	command.Model = layer.mViewProjection;
+	command.Model.Invert().Scale(2.0f);
+
+	command.UVMin      = vec2 {0.0f};
+	command.UVMax      = vec2 {1.0f};
+	command.Texture    = texture;
+	command.ArrayLayer = 0;
+	command.Color      = Color::WHITE;
+	command.Type       = PrimitiveType::Quad;
+
+	++mFrame->Stats.QuadCount;
+}
+
+void Renderer::DrawQuads(const SpriteInstance* sprites, u32 count)
+{
+	ScopedTime time(mTimeSubmission ? &mFrame->Stats.SubmitTime : nullptr);
+
+	u16 depth = GetDepthKey();
+	u32 i     = 0;
+
+#if ENGINE_CPU_X86_64
+	alignas(16) float c[4];
+	alignas(16) float s[4];
+
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128 sin4, cos4;
+		SinCos(_mm_setr_ps(sprites[i].Rotation,
+		                   sprites[i + 1].Rotation,
+		                   sprites[i + 2].Rotation,
+		                   sprites[i + 3].Rotation),
+		       sin4,
+		       cos4);
+		_mm_store_ps(c, cos4);
+		_mm_store_ps(s, sin4);
+
+		SubmitSprite(sprites[i], c[0], s[0], depth);
+		SubmitSprite(sprites[i + 1], c[1], s[1], depth);
+		SubmitSprite(sprites[i + 2], c[2], s[2], depth);
+		SubmitSprite(sprites[i + 3], c[3], s[3], depth);
+	}
+#endif
+
+	for(; i < count; ++i)
+	{
+		auto rad = float(Deg2Rad(sprites[i].Rotation));
+		SubmitSprite(sprites[i], std::cos(rad), std::sin(rad), depth);
+	}
+
+	mFrame->Stats.QuadCount += count;
+}
+
+void Renderer::SubmitSprite(const SpriteInstance& sprite,
+                            float                 c,
+                            float                 s,
+                            u16                   depth)
+{
+	const SubTexture* sub     = sprite.Sprite;
+	Texture*          texture = sub && sub->Texture ? sub->Texture.get()
+	                                                : mWhiteTexture.get();
+	if(texture != mWhiteTexture.get())
+		HoldTexture(sub->Texture);
+
+	u64 key = RenderQueue::MakeKey(sprite.Layer,
+	                               depth,
+	                               mBlendMode,
+	                               PrimitiveType::Quad,
+	                               GetRenderID(texture));
+
+	RenderCommand& command = mPass->Queue.Push(key);
+
+	// same as Translate(position).Rotate(rotation).Scale(size)
+	command.Model = Transform(c * sprite.Size.x,
+	                          -s * sprite.Size.y,
+	                          sprite.Position.x,
+	                          s * sprite.Size.x,
+	                          c * sprite.Size.y,
+	                          sprite.Position.y);
+
+	command.UVMin      = sub ? sub->UVMin : vec2 {0.0f};
+	command.UVMax      = sub ? sub->UVMax : vec2 {1.0f};
+	command.Texture    = texture;
+	command.ArrayLayer = sub ? sub->ArrayLayer : 0;
+	command.Color      = sprite.Color;
+	command.Type       = PrimitiveType::Quad;
+}
+
+void Renderer::SubmitQuad(const TexturePtr& texture,
+                          const Transform&  model,
+                          vec2              uvmin,
+                          vec2              uvmax,
+                          u32               array_layer)
+{
+	ScopedTime time(mTimeSubmission ? &mFrame->Stats.SubmitTime : nullptr);
+
+	// the white texture is the renderer's own
+	Texture* drawn = mWhiteTexture.get();
+	if(texture)
+	{
+		drawn = texture.get();
+		HoldTexture(texture);
+	}
+
+	u64            key     = MakeKey(PrimitiveType::Quad, drawn);
+	RenderCommand& command = mPass->Queue.Push(key);
+
+	command.Model      = model;
+	command.UVMin      = uvmin;
+	command.UVMax      = uvmax;
+	command.Texture    = drawn;
+	command.ArrayLayer = array_layer;
+	command.Color      = mColor;
+	command.Type       = PrimitiveType::Quad;
+
+	++mFrame->Stats.QuadCount;
+}
+
 void Renderer::DrawCircle(vec2  position,
                           float radius,
                           float thickness,
                           float smoothness)
 {
-	if(mCircleCount >= mMaxQuads)
-	{
-		Flush();
-	}
+	Transform model;
+	model.Translate(position).Scale(radius * 0.5f);
+
+	// unit circle, so thickness and smoothness stay relative to the size
+	RenderCommand& command =
+	        PushShape(ShapeType::Circle, model, thickness, smoothness);
+	command.Params[0] = 1.0f;
+}
 
+void Renderer::DrawRoundedRect(vec2  position,
+                               vec2  size,
+                               float corner_radius,
+                               float rotation,
+                               float thickness)
+{
 	Transform model;
-	model.Translate(position).Scale(radius);
-
-	u32 i = mCircleCount * 4;
-
-	mCircleVertices[i].WorldPosition = model * mQuadPositions[0];
-	mCircleVertices[i].LocalPosition = mCirclePositions[0];
-	mCircleVertices[i].Color         = mColor;
-	mCircleVertices[i].Thickness     = thickness;
-	mCircleVertices[i++].Smoothness  = smoothness;
-
-	mCircleVertices[i].WorldPosition = model * mQuadPositions[1];
-	mCircleVertices[i].LocalPosition = mCirclePositions[1];
-	mCircleVertices[i].Color         = mColor;
-	mCircleVertices[i].Thickness     = thickness;
-	mCircleVertices[i++].Smoothness  = smoothness;
-
-	mCircleVertices[i].WorldPosition = model * mQuadPositions[2];
-	mCircleVertices[i].LocalPosition = mCirclePositions[2];
-	mCircleVertices[i].Color         = mColor;
-	mCircleVertices[i].Thickness     = thickness;
-	mCircleVertices[i++].Smoothness  = smoothness;
-
-	mCircleVertices[i].WorldPosition = model * mQuadPositions[3];
-	mCircleVertices[i].LocalPosition = mCirclePositions[3];
-	mCircleVertices[i].Color         = mColor;
-	mCircleVertices[i].Thickness     = thickness;
-	mCircleVertices[i].Smoothness    = smoothness;
-
-	++mCircleCount;
-	++mStats.QuadCount;
+	model.Translate(position).Rotate(rotation);
+
+	vec2  half   = size * 0.5f;
+	float radius = std::clamp(corner_radius, 0.0f, std::min(half.x, half.y));
+
+	RenderCommand& command = PushShape(ShapeType::Box, model, thickness);
+	command.Params[0]      = half.x;
+	command.Params[1]      = half.y;
+	command.Params[2]      = radius;
+}
+
+void Renderer::DrawCapsule(vec2 a, vec2 b, float radius, float thickness)
+{
+	float     half_length;
+	Transform model = GetSegmentSpace(a, b, half_length);
+
+	RenderCommand& command = PushShape(ShapeType::Capsule, model, thickness);
+	command.Params[0]      = half_length;
+	command.Params[1]      = radius;
+}
+
+void Renderer::DrawLine(vec2 a, vec2 b, float width)
+{
+	float     half_length;
+	Transform model = GetSegmentSpace(a, b, half_length);
+
+	// a box along the segment, flat ends
+	RenderCommand& command = PushShape(ShapeType::Box, model, 0.0f);
+	command.Params[0]      = half_length;
+	command.Params[1]      = width * 0.5f;
+}
+
+void Renderer::DrawTriangle(vec2 a, vec2 b, vec2 c, float thickness)
+{
+	Transform model;
+	model.Translate(a);
+
+	RenderCommand& command = PushShape(ShapeType::Triangle, model, thickness);
+	command.Params[0]      = b.x - a.x;
+	command.Params[1]      = b.y - a.y;
+	command.Params[2]      = c.x - a.x;
+	command.Params[3]      = c.y - a.y;
+}
+
+RenderCommand& Renderer::PushShape(ShapeType        shape,
+                                   const Transform& model,
+                                   float            thickness,
+                                   float            smoothness)
+{
+	ScopedTime time(mTimeSubmission ? &mFrame->Stats.SubmitTime : nullptr);
+
+	u64            key     = MakeKey(PrimitiveType::Shape, nullptr);
+	RenderCommand& command = mPass->Queue.Push(key);
+
+	command.Model      = model;
+	command.Color      = mColor;
+	command.Thickness  = thickness;
+	command.Smoothness = smoothness;
+	command.Shape      = shape;
+	command.Type       = PrimitiveType::Shape;
+	std::fill_n(command.Params, 4, 0.0f);
+
+	++mFrame->Stats.ShapeCount;
+	return command;
 }
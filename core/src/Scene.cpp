@@ -4,11 +4,37 @@
 #include <Components.hpp>
 #include <Entity.hpp>
 
+static vec2 GetSpriteSize(const TransformComponent&      transform,
+                          const SpriteRendererComponent& sprite)
+{
+	vec2 size = transform.Scale * vec2(sprite.Sprite.Resolution);
+	size.x *= sprite.FlipX ? -1.0f : 1.0f;
+	size.y *= sprite.FlipY ? -1.0f : 1.0f;
+	return size;
+}
 
 Scene::Scene(String name)
         : mName(std::move(name)),
           mApp(nullptr)
 {
+	mRegistry.on_update<TransformComponent>().connect<&Scene::OnBoundsChanged>(*this);
+
+	mRegistry.on_construct<SpriteRendererComponent>()
+	        .connect<&Scene::OnBoundsChanged>(*this);
+	mRegistry.on_update<SpriteRendererComponent>()
+	        .connect<&Scene::OnBoundsChanged>(*this);
+	mRegistry.on_destroy<SpriteRendererComponent>()
+	        .connect<&Scene::OnBoundsChanged>(*this);
+
+	mRegistry.on_construct<CircleRendererComponent>()
+	        .connect<&Scene::OnBoundsChanged>(*this);
+	mRegistry.on_update<CircleRendererComponent>()
+	        .connect<&Scene::OnBoundsChanged>(*this);
+	mRegistry.on_destroy<CircleRendererComponent>()
+	        .connect<&Scene::OnBoundsChanged>(*this);
+
+	mRegistry.on_construct<StaticComponent>().connect<&Scene::OnBoundsChanged>(*this);
+	mRegistry.on_destroy<StaticComponent>().connect<&Scene::OnBoundsChanged>(*this);
 }
 
 Scene::~Scene() = default;
@@ -39,6 +65,10 @@ void Scene::DestroyEntity(Entity& entity)
 void Scene::DestroyAllEntities()
 {
 	mRegistry.clear();
+	mGrid.Clear();
+	mMoved.clear();
+	mStaticBatches.clear();
+	mStaticSprites.clear();
 }
 
 void Scene::Initialize()
@@ -68,46 +98,199 @@ void Scene::Render(double alpha)
 	        camera_view.get<TransformComponent, CameraComponent>(
 	                *camera_view.begin());
 
-	r.DrawBegin(camera.Camera.GetViewProjection());
+	const Transform& view_projection = camera.Camera.GetViewProjection();
+
+	r.DrawBegin(view_projection);
 
-	// Draw sprites
+	// World space bounds of the view, corners of clip space mapped back
+	AABB view_bounds;
 	{
-		auto group = mRegistry.group<TransformComponent>(
-		        entt::get<SpriteRendererComponent>);
-		for(auto entity : group)
-		{
-			auto [transform, sprite] =
-			        group.get<TransformComponent, SpriteRendererComponent>(entity);
+		Transform inverse = view_projection;
+		inverse.Invert();
 
-			vec2 size = transform.Scale * sprite.Texture->GetResolution();
-			size.x *= sprite.FlipX ? -1.0f : 1.0f;
-			size.y *= sprite.FlipY ? -1.0f : 1.0f;
+		const vec2 corners[4] = {
+		        {-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
 
-			r.SetColor(sprite.Color);
-			r.DrawRotatedQuad(
-			        sprite.Texture, transform.Position, size, transform.Rotation);
+		view_bounds.Min = view_bounds.Max = inverse * corners[0];
+		for(u32 i = 1; i < 4; ++i)
+		{
+			vec2 p            = inverse * corners[i];
+			view_bounds.Min.x = std::min(view_bounds.Min.x, p.x);
+			view_bounds.Min.y = std::min(view_bounds.Min.y, p.y);
+			view_bounds.Max.x = std::max(view_bounds.Max.x, p.x);
+			view_bounds.Max.y = std::max(view_bounds.Max.y, p.y);
 		}
 	}
 
-	// Draw circles
+	UpdateBounds();
+
+	for(const auto& batch : mStaticBatches)
+		r.DrawStaticBatch(*batch);
+
+	mVisible.clear();
+	mGrid.Query(view_bounds, mVisible);
+
+	// sprites are gathered and submitted in one call, the renderer handles them
+	// in bulk
+	mSprites.clear();
+
+	u32 circles = 0;
+	for(u32 id : mVisible)
 	{
-		auto view = mRegistry.view<TransformComponent, CircleRendererComponent>();
-		for(auto entity : view)
+		auto        entity    = entt::entity(id);
+		const auto& transform = mRegistry.get<TransformComponent>(entity);
+
+		auto* sprite = mRegistry.try_get<SpriteRendererComponent>(entity);
+		if(sprite && !mRegistry.all_of<StaticComponent>(entity))
 		{
-			auto [transform, circle] =
-			        view.get<TransformComponent, CircleRendererComponent>(entity);
+			SpriteInstance& instance = mSprites.emplace_back();
+
+			instance.Position = transform.Position;
+			instance.Size     = GetSpriteSize(transform, *sprite);
+			instance.Rotation = transform.Rotation;
+			instance.Color    = sprite->Color;
+			instance.Layer    = sprite->Layer;
+			instance.Sprite   = &sprite->Sprite;
+		}
 
-			r.SetColor(circle.Color);
+		if(auto* circle = mRegistry.try_get<CircleRendererComponent>(entity))
+		{
+			r.SetColor(circle->Color);
+			r.SetLayer(circle->Layer);
 			r.DrawCircle(transform.Position,
 			             transform.Scale.x * 32.0f,
-			             circle.Thickness,
-			             circle.Smoothness);
+			             circle->Thickness,
+			             circle->Smoothness);
+			++circles;
 		}
 	}
 
+	r.DrawQuads(mSprites.data(), u32(mSprites.size()));
+
+	u32 total = u32(mRegistry.view<SpriteRendererComponent>().size() +
+	                mRegistry.view<CircleRendererComponent>().size() -
+	                mStaticSprites.size());
+	u32 visible = u32(mSprites.size()) + circles;
+	r.SetCullStats(visible, total - visible);
+
 	r.DrawEnd();
 }
 
+void Scene::MarkMoved(entt::entity entity)
+{
+	mMoved.push_back(entity);
+}
+
+void Scene::OnBoundsChanged(RegistryType& registry, entt::entity entity)
+{
+	(void)registry;
+	mMoved.push_back(entity);
+}
+
+void Scene::UpdateBounds()
+{
+	for(entt::entity entity : mMoved)
+	{
+		auto id    = u32(entt::to_integral(entity));
+		bool valid = mRegistry.valid(entity);
+
+		auto* sprite =
+		        valid ? mRegistry.try_get<SpriteRendererComponent>(entity) : nullptr;
+		auto* circle =
+		        valid ? mRegistry.try_get<CircleRendererComponent>(entity) : nullptr;
+
+		// static sprites are drawn from their batch, not culled
+		if(sprite && mRegistry.all_of<StaticComponent>(entity))
+		{
+			UpdateStatic(id, mRegistry.get<TransformComponent>(entity), *sprite);
+			sprite = nullptr;
+		}
+		else
+			RemoveStatic(id);
+
+		if(!sprite && !circle)
+		{
+			mGrid.Remove(id);
+			continue;
+		}
+
+		const auto& transform = mRegistry.get<TransformComponent>(entity);
+
+		// Conservative: a circle around the sprite covers every rotation, so
+		// rotating does not change the bounds.
+		float extent = 0.0f;
+		if(sprite)
+		{
+			vec2 size = GetSpriteSize(transform, *sprite);
+			extent    = 0.5f * std::sqrt(size.x * size.x + size.y * size.y);
+		}
+		if(circle)
+			extent = std::max(extent, std::abs(transform.Scale.x * 32.0f));
+
+		mGrid.Update(id,
+		             {transform.Position - vec2 {extent},
+		              transform.Position + vec2 {extent}});
+	}
+
+	// the largest item may have shrunk or left
+	if(!mMoved.empty())
+		mGrid.Refit();
+
+	mMoved.clear();
+}
+
+void Scene::UpdateStatic(u32                            id,
+                         const TransformComponent&      transform,
+                         const SpriteRendererComponent& sprite)
+{
+	Transform model;
+	model.Translate(transform.Position)
+	        .Rotate(transform.Rotation)
+	        .Scale(GetSpriteSize(transform, sprite));
+
+	const Texture* texture = sprite.Sprite.Texture.get();
+
+	// updated in place while it still fits its batch
+	auto it = mStaticSprites.find(id);
+	if(it != mStaticSprites.end())
+	{
+		StaticBatch& batch = *mStaticBatches[it->second.Batch];
+		if(batch.GetLayer() == sprite.Layer && batch.CanAdd(texture))
+		{
+			batch.Update(it->second.Sprite, sprite.Sprite, model, sprite.Color);
+			return;
+		}
+
+		batch.Remove(it->second.Sprite);
+		mStaticSprites.erase(it);
+	}
+
+	// first batch of the same layer with a slot for the texture
+	u32 index = 0;
+	while(index < mStaticBatches.size() &&
+	      (mStaticBatches[index]->GetLayer() != sprite.Layer ||
+	       !mStaticBatches[index]->CanAdd(texture)))
+		++index;
+
+	if(index == mStaticBatches.size())
+		mStaticBatches.push_back(
+		        MakeUnique<StaticBatch>(mApp->GetRenderer(), sprite.Layer));
+
+	u32 handle = mStaticBatches[index]->Add(sprite.Sprite, model, sprite.Color);
+
+	mStaticSprites[id] = {index, handle};
+}
+
+void Scene::RemoveStatic(u32 id)
+{
+	auto it = mStaticSprites.find(id);
+	if(it == mStaticSprites.end())
+		return;
+
+	mStaticBatches[it->second.Batch]->Remove(it->second.Sprite);
+	mStaticSprites.erase(it);
+}
+
 void Scene::Resize(vec2ui resolution)
 {
 	auto  view            = mRegistry.view<CameraComponent>();
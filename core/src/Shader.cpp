@@ -3,13 +3,60 @@
 #include <Assert.hpp>
 #include <RenderDevice.hpp>
 #include <ShaderGL.hpp>
+#include <ShaderNull.hpp>
+#include <ShaderSource.hpp>
 
-ShaderPtr Shader::Create(const Path& path)
+Path Shader::sBinaryCache;
+Path Shader::sModuleDirectory;
+
+// Variants in use by ShaderSource::MakeKey. Shaders may be created on a render
+// thread as well.
+static HashMap<String, std::weak_ptr<Shader>> sVariants;
+static std::mutex                             sVariantsMutex;
+
+ShaderPtr Shader::Create(const Path&                   path,
+                         const StringArray&            defines,
+                         const Vector<ShaderConstant>& constants)
 {
+	String key = ShaderSource::MakeKey(path, defines, constants);
+
+	// held while compiling, a variant asked for twice at once compiles once
+	std::lock_guard lock(sVariantsMutex);
+
+	std::weak_ptr<Shader>& variant = sVariants[key];
+	if(ShaderPtr shader = variant.lock())
+		return shader;
+
+	ShaderPtr shader;
 	switch(RenderDevice::GetAPI())
 	{
-	case RenderAPI::GL: return MakeShared<ShaderGL>(path);
+	case RenderAPI::None: shader = MakeShared<ShaderNull>(path); break;
+	case RenderAPI::GL:
+		shader = MakeShared<ShaderGL>(ShaderSource(path, defines, constants));
+		break;
 	}
-	ASSERT(false, "Render API not supported");
-	return nullptr;
+	ASSERT(shader, "Render API not supported");
+
+	variant = shader;
+	return shader;
+}
+
+Vector<ShaderPtr> Shader::Create(const Vector<ShaderDesc>& shaders)
+{
+	Vector<ShaderPtr> created;
+	created.reserve(shaders.size());
+
+	for(const ShaderDesc& desc : shaders)
+		created.push_back(Create(desc.File, desc.Defines, desc.Constants));
+	return created;
+}
+
+void Shader::SetBinaryCache(const Path& directory)
+{
+	sBinaryCache = directory;
+}
+
+void Shader::SetModuleDirectory(const Path& directory)
+{
+	sModuleDirectory = directory;
 }
@@ -2,18 +2,68 @@
 
 #include <Assert.hpp>
 #include <Logger.hpp>
+#include <Timer.hpp>
 
-ShaderGL::ShaderGL(const Path& shaderfile)
-        : mProgramID(0)
+// Start of a program binary cache file, the binary follows
+struct ProgramBinaryHeader
 {
-	String source;
-	String vsource;
-	String fsource;
+	u32 Magic;
+	u32 Format;  // from glGetProgramBinary
+	u64 Key;     // ShaderGL::MakeBinaryKey
+	u32 Size;
+};
 
-	ReadFile(shaderfile, source);
-	Preprocess(source, vsource, fsource);
-	Compile(vsource, fsource);
-	Postprocess();
+static constexpr u32 ProgramBinaryMagic = 0x31425045;  // "EPB1"
+
+// KHR_parallel_shader_compile, the loader does not know it
+#ifndef GL_COMPLETION_STATUS_KHR
+	#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+bool ShaderGL::sParallelCompile = false;
+
+// FNV-1a
+static u64 HashBytes(u64 hash, const void* data, size_t size)
+{
+	auto* bytes = static_cast<const u8*>(data);
+	for(size_t i = 0; i < size; ++i)
+		hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+	return hash;
+}
+
+static bool IsBinaryFormatSupported(GLenum format)
+{
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count);
+
+	if(count <= 0)
+		return false;
+
+	Vector<GLint> formats(static_cast<size_t>(count));
+	glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+
+	return std::find(formats.cbegin(), formats.cend(), GLint(format)) !=
+	       formats.cend();
+}
+
+ShaderGL::ShaderGL(const ShaderSource& source)
+        : mProgramID(0),
+          mName(source.GetPath().filename().generic_string()),
+          mBinaryKey(MakeBinaryKey(source.GetVertex(), source.GetFragment())),
+          mCached(false),
+          mOrigin("compiled"),
+          mSubmitTime(Timer::TimeNow()),
+          mReady(false),
+          mFailed(false),
+          mUniformLocations(source.GetUniformLocations())
+{
+	mCached = LoadBinary(mBinaryKey);
+	if(mCached)
+		mOrigin = "loaded from cache";
+	else if(LoadModules(source))
+		mOrigin = "specialized from SPIR-V";
+	else
+		Compile(source.GetVertex(), source.GetFragment());
 }
 
 ShaderGL::~ShaderGL()
@@ -21,9 +71,41 @@ ShaderGL::~ShaderGL()
 	glDeleteProgram(mProgramID);
 }
 
+void ShaderGL::EnableParallelCompile(bool enable)
+{
+	sParallelCompile = enable;
+}
+
+bool ShaderGL::IsReady() const
+{
+	if(mReady)
+		return true;
+	if(mFailed)
+		return false;
+
+	if(sParallelCompile)
+	{
+		GLint done = GL_FALSE;
+		glGetProgramiv(mProgramID, GL_COMPLETION_STATUS_KHR, &done);
+		if(done != GL_TRUE)
+			return false;
+	}
+
+	Finish();
+	return mReady;
+}
+
+bool ShaderGL::IsValid() const
+{
+	Finish();
+	return !mFailed;
+}
+
 void ShaderGL::Bind() const
 {
-	glUseProgram(mProgramID);
+	Finish();
+	// the failed program would raise an error on every draw, see IsValid
+	glUseProgram(mFailed ? 0 : mProgramID);
 }
 
 void ShaderGL::Unbind() const
@@ -31,55 +113,55 @@ void ShaderGL::Unbind() const
 	glUseProgram(0);
 }
 
-void ShaderGL::SetDouble(const String& name, double v) const
+UniformHandle ShaderGL::GetUniform(const String& name) const
 {
+	Finish();
+
 	auto it = mUniformLocations.find(name);
-	ASSERT(it != mUniformLocations.cend());
+	if(it == mUniformLocations.cend())
+	{
+		// remembered as invalid, the by name setters would warn every frame
+		WARN("Uniform %s not found in shader %s", name, mName);
+		it = mUniformLocations.emplace(name, -1).first;
+	}
 
-	glProgramUniform1d(mProgramID, it->second, v);
+	return {it->second};
 }
 
-void ShaderGL::SetFloat(const String& name, float v) const
-{
-	auto it = mUniformLocations.find(name);
-	ASSERT(it != mUniformLocations.cend());
+// The handle was resolved after the link, so these do not wait for it. GL ignores
+// the location of an invalid handle.
 
-	glProgramUniform1f(mProgramID, it->second, v);
+void ShaderGL::SetDouble(UniformHandle uniform, double v) const
+{
+	glProgramUniform1d(mProgramID, uniform.Location, v);
 }
 
-void ShaderGL::SetInt(const String& name, int v) const
+void ShaderGL::SetFloat(UniformHandle uniform, float v) const
 {
-	auto it = mUniformLocations.find(name);
-	ASSERT(it != mUniformLocations.cend());
-
-	glProgramUniform1i(mProgramID, it->second, v);
+	glProgramUniform1f(mProgramID, uniform.Location, v);
 }
 
-void ShaderGL::SetUInt(const String& name, unsigned int v) const
+void ShaderGL::SetInt(UniformHandle uniform, int v) const
 {
-	auto it = mUniformLocations.find(name);
-	ASSERT(it != mUniformLocations.cend());
-
-	glProgramUniform1ui(mProgramID, mUniformLocations.at(name), v);
+	glProgramUniform1i(mProgramID, uniform.Location, v);
 }
 
-void ShaderGL::SetColor(const String& name, Color color) const
+void ShaderGL::SetUInt(UniformHandle uniform, unsigned int v) const
 {
-	auto it = mUniformLocations.find(name);
-	ASSERT(it != mUniformLocations.cend());
+	glProgramUniform1ui(mProgramID, uniform.Location, v);
+}
 
+void ShaderGL::SetColor(UniformHandle uniform, Color color) const
+{
 	float t[4];
 	color.GetColors(t);
-	glProgramUniform4fv(mProgramID, it->second, 4, t);
+	glProgramUniform4fv(mProgramID, uniform.Location, 1, t);
 }
 
-void ShaderGL::SetTransform(const String& name, const Transform& transform) const
+void ShaderGL::SetTransform(UniformHandle uniform, const Transform& transform) const
 {
-	auto it = mUniformLocations.find(name);
-	ASSERT(it != mUniformLocations.cend());
-
 	glProgramUniformMatrix3x2fv(
-	        mProgramID, it->second, 1, GL_TRUE, transform.GetPtr());
+	        mProgramID, uniform.Location, 1, GL_TRUE, transform.GetPtr());
 }
 
 u32 ShaderGL::GetID() const
@@ -87,93 +169,147 @@ u32 ShaderGL::GetID() const
 	return mProgramID;
 }
 
-void ShaderGL::ReadFile(const Path& shaderfile, String& source)
+void ShaderGL::Compile(const String& vsource, const String& fsource)
 {
-	std::ifstream in(shaderfile, std::ios::ate);
+	GLuint vsid = glCreateShader(GL_VERTEX_SHADER);
+	GLuint fsid = glCreateShader(GL_FRAGMENT_SHADER);
 
-	if(in)
-	{
-		size_t size = in.tellg();
-		if(size != -1)
-		{
-			source.resize(size);
-			in.seekg(0, std::ios::beg);
-			in.read(&source[0], (std::streamsize)size);
-		}
-		else
-		{
-			ERROR("Could not read from file {}",
-			      shaderfile.filename().generic_string());
-			return;
-		}
-	}
-	else
-	{
-		ERROR("Could not open file {}", shaderfile.filename().generic_string());
-		return;
-	}
+	const char* vsrc_ptr = vsource.c_str();
+	const char* fsrc_ptr = fsource.c_str();
+
+	glShaderSource(vsid, 1, &vsrc_ptr, nullptr);
+	glCompileShader(vsid);
+
+	glShaderSource(fsid, 1, &fsrc_ptr, nullptr);
+	glCompileShader(fsid);
+
+	LinkProgram(vsid, fsid);
 }
 
-void ShaderGL::Preprocess(const String& source, String& vsout, String& fsout)
+bool ShaderGL::LoadModules(const ShaderSource& source)
 {
-	std::regex vsregex(R"(\s*#\s*type\s+vertex\s*\r?\n)");
-	std::regex fsregex(R"(\s*#\s*type\s+fragment\s*\r?\n)");
-
-	std::smatch vsmatch;
-	std::smatch fsmatch;
+	if(sModuleDirectory.empty())
+		return false;
 
-	if(!std::regex_search(source, vsmatch, vsregex))
+	String base = (sModuleDirectory / source.GetModuleName()).string();
+	GLuint vsid = LoadModule(GL_VERTEX_SHADER, base + ".vert.spv", source);
+	GLuint fsid = LoadModule(GL_FRAGMENT_SHADER, base + ".frag.spv", source);
+	if(vsid == 0 || fsid == 0)
 	{
-		ERROR("\"#type vertex\" specifier not found.");
-		return;
+		// glDeleteShader ignores 0
+		glDeleteShader(vsid);
+		glDeleteShader(fsid);
+		return false;
 	}
 
-	if(!std::regex_search(source, fsmatch, fsregex))
+	LinkProgram(vsid, fsid);
+	return true;
+}
+
+GLuint ShaderGL::LoadModule(GLenum              type,
+                            const Path&         path,
+                            const ShaderSource& source)
+{
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if(!in)
+		return 0;
+
+	Vector<char> module(size_t(in.tellg()));
+	in.seekg(0, std::ios::beg);
+	in.read(module.data(), std::streamsize(module.size()));
+	if(!in)
+		return 0;
+
+	// a module of an older source would be cached under the key of the new one
+	ShaderModuleHeader header {};
+	if(module.size() > sizeof(header))
+		std::memcpy(&header, module.data(), sizeof(header));
+	if(header.Magic != ShaderModuleMagic || header.Hash != source.GetHash())
 	{
-		ERROR("\"#type fragment\" specifier not found.");
-		return;
+		WARN("SPIR-V module %s is stale, compiling GLSL",
+		     path.filename().generic_string());
+		return 0;
 	}
 
-	size_t vpos = vsmatch.position(0);
-	size_t fpos = fsmatch.position(0);
-	if(vpos < fpos)
+	Vector<GLuint> ids;
+	Vector<GLuint> values;
+	for(const ShaderConstant& constant : source.GetConstants())
 	{
-		vsout = source.substr(vpos + vsmatch.length(0),
-		                      fpos - (vpos + vsmatch.length(0)));
-		fsout = fsmatch.suffix();
+		ids.push_back(constant.ID);
+		values.push_back(constant.Value);
 	}
-	else
+
+	GLuint id = glCreateShader(type);
+	glShaderBinary(1,
+	               &id,
+	               GL_SHADER_BINARY_FORMAT_SPIR_V,
+	               module.data() + sizeof(header),
+	               GLsizei(module.size() - sizeof(header)));
+	glSpecializeShader(id, "main", GLuint(ids.size()), ids.data(), values.data());
+
+	// specializing compiles, a broken or foreign module fails here
+	GLint compiled = GL_FALSE;
+	glGetShaderiv(id, GL_COMPILE_STATUS, &compiled);
+	if(compiled != GL_TRUE)
 	{
-		fsout = source.substr(fpos + fsmatch.length(0),
-		                      vpos - (fpos + fsmatch.length(0)));
-		vsout = vsmatch.suffix();
+		char log[512] {};
+		glGetShaderInfoLog(id, sizeof(log), nullptr, log);
+		WARN("SPIR-V module %s rejected, compiling GLSL: %s",
+		     path.filename().generic_string(),
+		     log);
+		glDeleteShader(id);
+		return 0;
 	}
+
+	return id;
 }
 
-void ShaderGL::Compile(const String& vsource, const String& fsource)
+void ShaderGL::LinkProgram(GLuint vsid, GLuint fsid)
 {
-	GLuint vsid = glCreateShader(GL_VERTEX_SHADER);
-	GLuint fsid = glCreateShader(GL_FRAGMENT_SHADER);
-	mProgramID  = glCreateProgram();
-
-	const char* vsrc_ptr = vsource.c_str();
-	const char* fsrc_ptr = fsource.c_str();
-
-	glShaderSource(vsid, 1, &vsrc_ptr, nullptr);
-	glCompileShader(vsid);
-
-	glShaderSource(fsid, 1, &fsrc_ptr, nullptr);
-	glCompileShader(fsid);
+	mProgramID = glCreateProgram();
 
 	glAttachShader(mProgramID, vsid);
 	glAttachShader(mProgramID, fsid);
 
+	if(!sBinaryCache.empty())
+		glProgramParameteri(mProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
 	glLinkProgram(mProgramID);
 	glDeleteShader(vsid);
 	glDeleteShader(fsid);
 }
 
-void ShaderGL::Postprocess()
+void ShaderGL::Finish() const
+{
+	std::call_once(mLinked, &ShaderGL::Link, this);
+}
+
+void ShaderGL::Link() const
+{
+	// waits for the driver if it is not done yet
+	GLint linked = GL_FALSE;
+	glGetProgramiv(mProgramID, GL_LINK_STATUS, &linked);
+	if(linked != GL_TRUE)
+	{
+		char log[512] {};
+		glGetProgramInfoLog(mProgramID, sizeof(log), nullptr, log);
+		ERROR("Shader %s failed to link: %s", mName, log);
+		mFailed = true;
+		return;
+	}
+
+	if(!mCached)
+		SaveBinary(mBinaryKey);
+	Postprocess();
+
+	INFO("Shader %s %s, ready %.2f ms after it was submitted",
+	     mName,
+	     mOrigin,
+	     (Timer::TimeNow() - mSubmitTime) * 1000.0);
+	mReady = true;
+}
+
+void ShaderGL::Postprocess() const
 {
 	GLint count = 0;
 	glGetProgramInterfaceiv(mProgramID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
@@ -189,6 +325,10 @@ void ShaderGL::Postprocess()
 		if(values[0] != -1)
 			continue;
 
+		// SPIR-V programs may have no names, see ShaderSource
+		if(values[1] <= 1)
+			continue;
+
 		String name;
 		name.resize(size_t(values[1]) - 1);  // resize to retrieved size minus 1
 		// because we don't consider null termination
@@ -198,6 +338,119 @@ void ShaderGL::Postprocess()
 	}
 }
 
+u64 ShaderGL::MakeBinaryKey(const String& vsource, const String& fsource)
+{
+	// the strings RenderDeviceInfo is filled from, binaries of another driver
+	// build are useless
+	const char* driver[3] = {(const char*)glGetString(GL_VENDOR),
+	                         (const char*)glGetString(GL_RENDERER),
+	                         (const char*)glGetString(GL_VERSION)};
+
+	// the terminating nulls keep "ab" + "c" apart from "a" + "bc"
+	u64 key = 0xcbf29ce484222325ull;
+	key     = HashBytes(key, vsource.c_str(), vsource.size() + 1);
+	key     = HashBytes(key, fsource.c_str(), fsource.size() + 1);
+	for(const char* s : driver)
+		key = HashBytes(key, s, std::strlen(s) + 1);
+	return key;
+}
+
+Path ShaderGL::GetBinaryPath(u64 key)
+{
+	char name[24];
+	std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+	return sBinaryCache / name;
+}
+
+bool ShaderGL::LoadBinary(u64 key)
+{
+	if(sBinaryCache.empty())
+		return false;
+
+	std::ifstream in(GetBinaryPath(key), std::ios::binary | std::ios::ate);
+	if(!in)
+		return false;
+
+	const auto length = size_t(in.tellg());
+	in.seekg(0, std::ios::beg);
+
+	ProgramBinaryHeader header {};
+	in.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if(!in || header.Magic != ProgramBinaryMagic || header.Key != key ||
+	   !IsBinaryFormatSupported(header.Format))
+		return false;
+
+	// a truncated or corrupt file, before allocating what it claims
+	if(header.Size == 0 || header.Size != length - sizeof(header))
+	{
+		WARN("Shader cache %s is damaged, compiling",
+		     GetBinaryPath(key).filename().generic_string());
+		return false;
+	}
+
+	Vector<u8> binary(header.Size);
+	in.read(reinterpret_cast<char*>(binary.data()), header.Size);
+	if(!in)
+		return false;
+
+	mProgramID = glCreateProgram();
+	glProgramBinary(mProgramID, header.Format, binary.data(), GLsizei(header.Size));
+
+	// drivers may still reject it, after an update for example
+	GLint linked = GL_FALSE;
+	glGetProgramiv(mProgramID, GL_LINK_STATUS, &linked);
+	if(linked == GL_TRUE)
+		return true;
+
+	WARN("Cached shader program rejected by the driver, compiling");
+	glDeleteProgram(mProgramID);
+	mProgramID = 0;
+	return false;
+}
+
+void ShaderGL::SaveBinary(u64 key) const
+{
+	if(sBinaryCache.empty())
+		return;
+
+	// zero if linking failed or the driver has no binary formats
+	GLint size = 0;
+	glGetProgramiv(mProgramID, GL_PROGRAM_BINARY_LENGTH, &size);
+	if(size <= 0)
+		return;
+
+	ProgramBinaryHeader header {ProgramBinaryMagic, 0, key, u32(size)};
+	Vector<u8>          binary(header.Size);
+	glGetProgramBinary(mProgramID, size, nullptr, &header.Format, binary.data());
+
+	std::error_code error;
+	fs::create_directories(sBinaryCache, error);
+
+	// written aside and renamed, a crash never leaves a partial file in place
+	Path path      = GetBinaryPath(key);
+	Path temporary = path;
+	temporary += ".tmp";
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(binary.data()), header.Size);
+		if(!out)
+		{
+			WARN("Could not write shader cache %s", path.generic_string());
+			out.close();
+			fs::remove(temporary, error);
+			return;
+		}
+	}
+
+	fs::rename(temporary, path, error);
+	if(error)
+	{
+		WARN("Could not write shader cache %s", path.generic_string());
+		fs::remove(temporary, error);
+	}
+}
+
 GLenum ShaderGL::ShaderTypeMap(ShaderType type)
 {
 	switch(type)
@@ -0,0 +1,47 @@
+#include <ShaderNull.hpp>
+
+#include <RenderDeviceNull.hpp>
+
+ShaderNull::ShaderNull(const Path&)
+        : mID(RenderDeviceNull::GenerateID())
+{
+}
+
+bool ShaderNull::IsReady() const
+{
+	return true;
+}
+
+bool ShaderNull::IsValid() const
+{
+	return true;
+}
+
+void ShaderNull::Bind() const
+{
+	RenderDeviceNull::Record(NullCommandType::BindShader, mID, 0);
+}
+
+void ShaderNull::Unbind() const {}
+
+UniformHandle ShaderNull::GetUniform(const String&) const
+{
+	return {};
+}
+
+void ShaderNull::SetDouble(UniformHandle, double) const {}
+
+void ShaderNull::SetFloat(UniformHandle, float) const {}
+
+void ShaderNull::SetInt(UniformHandle, int) const {}
+
+void ShaderNull::SetUInt(UniformHandle, unsigned int) const {}
+
+void ShaderNull::SetColor(UniformHandle, Color) const {}
+
+void ShaderNull::SetTransform(UniformHandle, const Transform&) const {}
+
+u32 ShaderNull::GetID() const
+{
+	return mID;
+}
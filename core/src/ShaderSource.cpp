@@ -0,0 +1,312 @@
+#include <ShaderSource.hpp>
+
+#include <Logger.hpp>
+
+// FNV-1a, like the program binary keys of ShaderGL
+static u64 HashText(u64 hash, std::string_view text)
+{
+	for(char c : text)
+		hash = (hash ^ u8(c)) * 0x100000001b3ull;
+	return hash;
+}
+
+// True if line is the directive #name, argument is what follows it
+static bool ReadDirective(std::string_view  line,
+                          std::string_view  name,
+                          std::string_view& argument)
+{
+	size_t i = line.find_first_not_of(" \t");
+	if(i == std::string_view::npos || line[i] != '#')
+		return false;
+
+	i = line.find_first_not_of(" \t", i + 1);
+	if(i == std::string_view::npos || line.compare(i, name.size(), name) != 0)
+		return false;
+
+	// #include is not #includes
+	i += name.size();
+	if(i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r')
+		return false;
+
+	size_t begin = line.find_first_not_of(" \t", i);
+	size_t end   = line.find_last_not_of(" \t\r");
+	argument     = begin == std::string_view::npos || end < begin
+	                       ? std::string_view()
+	                       : line.substr(begin, end - begin + 1);
+	return true;
+}
+
+// True if line declares something with layout(... qualifier = value ...),
+// declaration is what follows the layout
+static bool ReadLayout(std::string_view  line,
+                       std::string_view  qualifier,
+                       u32&              value,
+                       std::string_view& declaration)
+{
+	size_t i = line.find_first_not_of(" \t");
+	if(i == std::string_view::npos || line.compare(i, 6, "layout") != 0)
+		return false;
+
+	size_t open  = line.find('(', i);
+	size_t close = line.find(')', i);
+	if(open == std::string_view::npos || close == std::string_view::npos ||
+	   close < open)
+		return false;
+
+	std::string_view qualifiers = line.substr(open + 1, close - open - 1);
+	size_t           q          = qualifiers.find(qualifier);
+	if(q == std::string_view::npos)
+		return false;
+
+	size_t equals = qualifiers.find_first_not_of(" \t", q + qualifier.size());
+	if(equals == std::string_view::npos || qualifiers[equals] != '=')
+		return false;
+
+	String number(qualifiers.substr(equals + 1));
+	value = u32(std::strtoul(number.c_str(), nullptr, 0));
+
+	size_t begin = line.find_first_not_of(" \t", close + 1);
+	declaration  = begin == std::string_view::npos ? std::string_view()
+	                                                : line.substr(begin);
+	return true;
+}
+
+// The last word before the array size or the semicolon
+static String ReadName(std::string_view declaration)
+{
+	std::string_view head  = declaration.substr(0, declaration.find_first_of("[;="));
+	size_t           last  = head.find_last_not_of(" \t");
+	size_t           first = head.find_last_of(" \t", last);
+	if(last == std::string_view::npos || first == std::string_view::npos)
+		return String();
+
+	return String(head.substr(first + 1, last - first));
+}
+
+ShaderSource::ShaderSource(const Path&                   path,
+                           const StringArray&            defines,
+                           const Vector<ShaderConstant>& constants,
+                           ShaderTarget                  target)
+        : mPath(path),
+          mConstants(constants),
+          mTarget(target),
+          mModuleName(path.stem().generic_string()),
+          mHash(0xcbf29ce484222325ull),
+          mStage(nullptr)
+{
+	StringArray sorted = defines;
+	std::sort(sorted.begin(), sorted.end());
+
+	for(const String& define : sorted)
+	{
+		size_t value = define.find('=');
+		if(value == String::npos)
+			mDefines += "#define " + define + '\n';
+		else
+			mDefines += "#define " + define.substr(0, value) + ' ' +
+			            define.substr(value + 1) + '\n';
+
+		// QuadShader.INSTANCED, NAME=VALUE as NAME-VALUE
+		String part = define;
+		std::replace(part.begin(), part.end(), '=', '-');
+		mModuleName += '.' + part;
+	}
+
+	mHash = HashText(mHash, mDefines);
+	Append(mPath, false);
+
+	if(mVertex.empty())
+		ERROR("\"#type vertex\" specifier not found in %s",
+		      mPath.filename().generic_string());
+	if(mFragment.empty())
+		ERROR("\"#type fragment\" specifier not found in %s",
+		      mPath.filename().generic_string());
+}
+
+String ShaderSource::MakeKey(const Path&                   path,
+                             const StringArray&            defines,
+                             const Vector<ShaderConstant>& constants)
+{
+	StringArray sorted = defines;
+	for(const ShaderConstant& constant : constants)
+		sorted.push_back('#' + std::to_string(constant.ID) + '=' +
+		                 std::to_string(constant.Value));
+	std::sort(sorted.begin(), sorted.end());
+
+	String key = path.lexically_normal().generic_string();
+	for(const String& define : sorted)
+		key += '\n' + define;
+	return key;
+}
+
+void ShaderSource::Append(const Path& path, bool included)
+{
+	const String* file = ReadFile(path);
+	if(!file)
+		return;
+
+	size_t next = 0;
+	while(next < file->size())
+	{
+		size_t end = file->find('\n', next);
+		if(end == String::npos)
+			end = file->size();
+
+		std::string_view line(file->data() + next, end - next);
+		std::string_view argument;
+		next = end + 1;
+
+		// with the newline, "ab" + "c" is not "a" + "bc"
+		mHash = HashText(HashText(mHash, line), "\n");
+
+		if(ReadDirective(line, "type", argument))
+		{
+			if(included)
+			{
+				ERROR("#type in included file %s", path.filename().generic_string());
+				continue;
+			}
+
+			if(argument == "vertex")
+				mStage = &mVertex;
+			else if(argument == "fragment")
+				mStage = &mFragment;
+			else
+			{
+				ERROR("Unknown shader type %s", String(argument));
+				mStage = nullptr;
+			}
+
+			mIncluded.clear();
+			mIncluded.insert(mPath.lexically_normal().generic_string());
+			continue;
+		}
+
+		// nothing before the first #type belongs to a stage
+		if(!mStage)
+			continue;
+
+		if(ReadDirective(line, "include", argument))
+		{
+			if(argument.size() < 2)
+			{
+				ERROR("Missing file name in %s", path.filename().generic_string());
+				continue;
+			}
+
+			// "file" or <file>, both relative to this file
+			Path include = path.parent_path() /
+			               String(argument.substr(1, argument.size() - 2));
+			if(mIncluded.insert(include.lexically_normal().generic_string()).second)
+				Append(include, true);
+			continue;
+		}
+
+		u32 value = 0;
+		if(mTarget == ShaderTarget::GLSL &&
+		   ReadLayout(line, "constant_id", value, argument))
+		{
+			AppendConstant(argument, value);
+			continue;
+		}
+
+		if(ReadLayout(line, "location", value, argument) &&
+		   argument.compare(0, 7, "uniform") == 0)
+			mUniformLocations[ReadName(argument)] = i32(value);
+
+		mStage->append(line);
+		mStage->push_back('\n');
+
+		if(ReadDirective(line, "version", argument))
+			mStage->append(mDefines);
+	}
+}
+
+void ShaderSource::AppendConstant(std::string_view declaration, u32 id)
+{
+	auto constant = std::find_if(mConstants.cbegin(),
+	                             mConstants.cend(),
+	                             [id](const ShaderConstant& c)
+	                             { return c.ID == id; });
+
+	// const TYPE NAME = DEFAULT;
+	size_t keyword = declaration.find("const");
+	size_t type    = keyword == std::string_view::npos
+	                         ? keyword
+	                         : declaration.find_first_not_of(" \t", keyword + 5);
+	size_t equals  = declaration.find('=');
+	size_t end     = declaration.find(';');
+	if(constant == mConstants.cend() || type == std::string_view::npos ||
+	   equals == std::string_view::npos || end == std::string_view::npos ||
+	   end < equals)
+	{
+		// the default, without the layout
+		mStage->append(declaration);
+		mStage->push_back('\n');
+		return;
+	}
+
+	std::string_view name = declaration.substr(
+	        type, declaration.find_first_of(" \t", type) - type);
+
+	String value;
+	if(name == "bool")
+		value = constant->Value ? "true" : "false";
+	else if(name == "int")
+		value = std::to_string(i32(constant->Value));
+	else if(name == "uint")
+		value = std::to_string(constant->Value) + 'u';
+	else if(name == "float")
+	{
+		float f;
+		std::memcpy(&f, &constant->Value, sizeof(f));
+
+		char text[32];
+		std::snprintf(text, sizeof(text), "%.9g", double(f));
+		value = text;
+	}
+	else
+	{
+		ERROR("Specialization constant %u is not a bool, int, uint or float", id);
+		value = String(declaration.substr(equals + 1, end - equals - 1));
+	}
+
+	mStage->append(declaration.substr(0, equals + 1));
+	mStage->append(' ' + value);
+	mStage->append(declaration.substr(end));
+	mStage->push_back('\n');
+}
+
+const String* ShaderSource::ReadFile(const Path& path)
+{
+	// shaders may be created on a render thread as well. Entries are never
+	// erased, pointers to them stay valid after the lock is released.
+	static HashMap<String, String> sFiles;
+	static std::mutex              sFilesMutex;
+
+	std::lock_guard lock(sFilesMutex);
+
+	String key = path.lexically_normal().generic_string();
+	auto   it  = sFiles.find(key);
+	if(it != sFiles.end())
+		return &it->second;
+
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if(!in)
+	{
+		ERROR("Could not open file %s", path.filename().generic_string());
+		return nullptr;
+	}
+
+	String source;
+	source.resize(size_t(in.tellg()));
+	in.seekg(0, std::ios::beg);
+	in.read(&source[0], std::streamsize(source.size()));
+	if(!in)
+	{
+		ERROR("Could not read from file %s", path.filename().generic_string());
+		return nullptr;
+	}
+
+	return &sFiles.emplace(std::move(key), std::move(source)).first->second;
+}
@@ -0,0 +1,144 @@
+#include <SpatialGrid.hpp>
+
+SpatialGrid::SpatialGrid(float cell_size)
+        : mCellSize(cell_size),
+          mMaxHalfExtent(0.0f),
+          mRefit(false)
+{
+}
+
+void SpatialGrid::Update(u32 id, const AABB& bounds)
+{
+	vec2 half        = (bounds.Max - bounds.Min) * 0.5f;
+	mMaxHalfExtent.x = std::max(mMaxHalfExtent.x, half.x);
+	mMaxHalfExtent.y = std::max(mMaxHalfExtent.y, half.y);
+
+	u64 cell = GetCell((bounds.Min + bounds.Max) * 0.5f);
+
+	auto it = mItems.find(id);
+	if(it != mItems.end())
+	{
+		AABB& old = mCells[it->second.Cell][it->second.Slot].Bounds;
+		Release(old, half);
+
+		// still in the same cell, nothing to relink
+		if(it->second.Cell == cell)
+		{
+			old = bounds;
+			return;
+		}
+
+		Unlink(it->second);
+	}
+
+	Vector<Entry>& entries = mCells[cell];
+	mItems[id]             = {cell, u32(entries.size())};
+	entries.push_back({bounds, id});
+}
+
+void SpatialGrid::Remove(u32 id)
+{
+	auto it = mItems.find(id);
+	if(it == mItems.end())
+		return;
+
+	Release(mCells[it->second.Cell][it->second.Slot].Bounds, vec2 {0.0f});
+	Unlink(it->second);
+	mItems.erase(it);
+}
+
+void SpatialGrid::Clear()
+{
+	mCells.clear();
+	mItems.clear();
+	mMaxHalfExtent = vec2 {0.0f};
+	mRefit         = false;
+}
+
+void SpatialGrid::Refit()
+{
+	if(!mRefit)
+		return;
+
+	mMaxHalfExtent = vec2 {0.0f};
+	for(const auto& [cell, entries] : mCells)
+	{
+		for(const Entry& e : entries)
+		{
+			vec2 half        = (e.Bounds.Max - e.Bounds.Min) * 0.5f;
+			mMaxHalfExtent.x = std::max(mMaxHalfExtent.x, half.x);
+			mMaxHalfExtent.y = std::max(mMaxHalfExtent.y, half.y);
+		}
+	}
+
+	mRefit = false;
+}
+
+void SpatialGrid::Query(const AABB& area, Vector<u32>& result) const
+{
+	auto test = [&area, &result](const Vector<Entry>& entries)
+	{
+		for(const Entry& e : entries)
+			if(e.Bounds.Overlaps(area))
+				result.push_back(e.ID);
+	};
+
+	// items are binned by center, so widen the area by the largest half extent
+	vec2 min = area.Min - mMaxHalfExtent;
+	vec2 max = area.Max + mMaxHalfExtent;
+
+	auto x0 = i64(std::floor(min.x / mCellSize));
+	auto y0 = i64(std::floor(min.y / mCellSize));
+	auto x1 = i64(std::floor(max.x / mCellSize));
+	auto y1 = i64(std::floor(max.y / mCellSize));
+
+	// zoomed far out, visiting the occupied cells is cheaper than the range
+	if((x1 - x0 + 1) * (y1 - y0 + 1) > i64(mCells.size()))
+	{
+		for(const auto& [cell, entries] : mCells)
+			test(entries);
+		return;
+	}
+
+	for(i64 y = y0; y <= y1; ++y)
+	{
+		for(i64 x = x0; x <= x1; ++x)
+		{
+			auto it = mCells.find((u64(u32(x)) << 32) | u32(y));
+			if(it != mCells.end())
+				test(it->second);
+		}
+	}
+}
+
+u64 SpatialGrid::GetCell(vec2 point) const
+{
+	auto x = i32(std::floor(point.x / mCellSize));
+	auto y = i32(std::floor(point.y / mCellSize));
+	return (u64(u32(x)) << 32) | u32(y);
+}
+
+void SpatialGrid::Release(const AABB& bounds, vec2 replacement)
+{
+	// the largest item shrinking may leave the margin too wide
+	vec2 half = (bounds.Max - bounds.Min) * 0.5f;
+	if((half.x >= mMaxHalfExtent.x && replacement.x < half.x) ||
+	   (half.y >= mMaxHalfExtent.y && replacement.y < half.y))
+		mRefit = true;
+}
+
+void SpatialGrid::Unlink(const Item& item)
+{
+	// swap with the last entry so removal is O(1)
+	Vector<Entry>& entries = mCells[item.Cell];
+
+	if(item.Slot != entries.size() - 1)
+	{
+		entries[item.Slot]                 = entries.back();
+		mItems[entries[item.Slot].ID].Slot = item.Slot;
+	}
+	entries.pop_back();
+
+	if(entries.empty())
+		mCells.erase(item.Cell);
+}
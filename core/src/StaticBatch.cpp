@@ -0,0 +1,198 @@
+#include <StaticBatch.hpp>
+
+#include <Assert.hpp>
+
+StaticBatch::StaticBatch(const Renderer& renderer, u8 layer, u32 capacity)
+        : mLayer(layer),
+          mCapacity(0),
+          mQuadCount(0),
+          mDirtyBegin(0),
+          mDirtyEnd(0),
+          mTextureSlots(renderer.GetTextureSlots())
+{
+	mSlots.resize(mTextureSlots + renderer.GetArraySlots());
+	mSlotUses.resize(mSlots.size(), 0);
+	mSlots[0] = renderer.GetWhiteTexture();
+
+	Grow(std::max(capacity, 1u));
+}
+
+bool StaticBatch::CanAdd(const Texture* texture) const
+{
+	if(!texture || FindSlot(texture) != mSlots.size())
+		return true;
+
+	return FindFreeSlot(texture) != mSlots.size();
+}
+
+u32 StaticBatch::Add(const SubTexture& sprite, const Transform& model, Color color)
+{
+	u32 quad;
+	if(!mFree.empty())
+	{
+		quad = mFree.back();
+		mFree.pop_back();
+	}
+	else
+	{
+		if(mQuadCount == mCapacity)
+			Grow(mCapacity * 2);
+		quad = mQuadCount++;
+	}
+
+	Write(quad, sprite, model, color);
+	return quad;
+}
+
+void StaticBatch::Update(u32               handle,
+                         const SubTexture& sprite,
+                         const Transform&  model,
+                         Color             color)
+{
+	ASSERT(handle < mQuadCount, "Invalid static sprite handle");
+
+	// the old slot goes after the new one is taken, the same texture keeps it
+	u32 slot = u32(mVertices[size_t(handle) * 4].TexID);
+	Write(handle, sprite, model, color);
+	ReleaseSlot(slot);
+}
+
+void StaticBatch::Remove(u32 handle)
+{
+	ASSERT(handle < mQuadCount, "Invalid static sprite handle");
+
+	ReleaseSlot(u32(mVertices[size_t(handle) * 4].TexID));
+
+	// zero area, nothing is rasterized
+	std::fill_n(&mVertices[size_t(handle) * 4], 4, QuadVertex {});
+
+	mFree.push_back(handle);
+	mDirtyBegin = std::min(mDirtyBegin, handle);
+	mDirtyEnd   = std::max(mDirtyEnd, handle + 1);
+}
+
+u32 StaticBatch::TakeChanges(Vector<QuadVertex>& vertices)
+{
+	if(mDirtyBegin >= mDirtyEnd)
+		return 0;
+
+	u32 first = mDirtyBegin * 4;
+	vertices.insert(vertices.end(),
+	                mVertices.begin() + first,
+	                mVertices.begin() + size_t(mDirtyEnd) * 4);
+
+	mDirtyBegin = mCapacity;
+	mDirtyEnd   = 0;
+	return first;
+}
+
+u32 StaticBatch::FindSlot(const Texture* texture) const
+{
+	for(u32 i = 0; i < mSlots.size(); ++i)
+		if(mSlots[i].get() == texture)
+			return i;
+	return u32(mSlots.size());
+}
+
+u32 StaticBatch::FindFreeSlot(const Texture* texture) const
+{
+	// slot 0 is the white texture
+	u32 begin = texture->IsArray() ? mTextureSlots : 1;
+	u32 end   = texture->IsArray() ? u32(mSlots.size()) : mTextureSlots;
+	for(u32 i = begin; i < end; ++i)
+		if(!mSlots[i])
+			return i;
+	return u32(mSlots.size());
+}
+
+u32 StaticBatch::GetSlot(const TexturePtr& texture)
+{
+	if(!texture)
+		return 0;
+
+	u32 slot = FindSlot(texture.get());
+	if(slot == mSlots.size())
+	{
+		slot = FindFreeSlot(texture.get());
+		ASSERT(slot != mSlots.size(), "Static batch texture slots are full");
+		mSlots[slot] = texture;
+	}
+
+	++mSlotUses[slot];
+	return slot;
+}
+
+void StaticBatch::ReleaseSlot(u32 slot)
+{
+	// the white texture stays, removed quads point at it too
+	if(slot == 0)
+		return;
+
+	ASSERT(mSlotUses[slot] > 0, "Static batch slot released too often");
+	if(--mSlotUses[slot] == 0)
+		mSlots[slot].reset();
+}
+
+void StaticBatch::Write(u32               quad,
+                        const SubTexture& sprite,
+                        const Transform&  model,
+                        Color             color)
+{
+	auto slot  = static_cast<float>(GetSlot(sprite.Texture));
+	auto layer = static_cast<float>(sprite.ArrayLayer);
+
+	const vec2 corners[4] = {
+	        {-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+	const vec2 uv[4] = {sprite.UVMin,
+	                    {sprite.UVMax.x, sprite.UVMin.y},
+	                    sprite.UVMax,
+	                    {sprite.UVMin.x, sprite.UVMax.y}};
+
+	QuadVertex* v = &mVertices[size_t(quad) * 4];
+	for(u32 c = 0; c < 4; ++c)
+	{
+		v[c].Position   = model * corners[c];
+		v[c].UV         = uv[c];
+		v[c].Color      = color;
+		v[c].TexID      = slot;
+		v[c].ArrayLayer = layer;
+	}
+
+	mDirtyBegin = std::min(mDirtyBegin, quad);
+	mDirtyEnd   = std::max(mDirtyEnd, quad + 1);
+}
+
+void StaticBatch::Grow(u32 capacity)
+{
+	mCapacity = capacity;
+	mVertices.resize(size_t(mCapacity) * 4);
+
+	Vector<u32> indices(size_t(mCapacity) * 6);
+	for(u32 offset = 0, i = 0; i < indices.size(); i += 6, offset += 4)
+	{
+		indices[i]     = offset;
+		indices[i + 1] = offset + 1;
+		indices[i + 2] = offset + 2;
+
+		indices[i + 3] = offset + 2;
+		indices[i + 4] = offset + 3;
+		indices[i + 5] = offset;
+	}
+
+	mVB = VertexBuffer::Create({Vertex {VertexType::Float2},
+	                            Vertex {VertexType::Float2},
+	                            Vertex {VertexType::UByte4, true},
+	                            Vertex {VertexType::Float},
+	                            Vertex {VertexType::Float}},
+	                           mCapacity * 4,
+	                           sizeof(QuadVertex));
+	mIB = IndexBuffer::Create(indices.data(), u32(indices.size()));
+
+	mVA = VertexArray::Create();
+	mVA->AttachIndexBuffer(mIB);
+	mVA->AttachVertexBuffer(mVB);
+
+	// new buffer, everything written so far has to go up again
+	mDirtyBegin = 0;
+	mDirtyEnd   = mQuadCount;
+}
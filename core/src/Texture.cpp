@@ -3,11 +3,13 @@
 #include <Assert.hpp>
 #include <RenderDevice.hpp>
 #include <TextureGL.hpp>
+#include <TextureNull.hpp>
 
 TexturePtr Texture::Create()
 {
 	switch(RenderDevice::GetAPI())
 	{
+	case RenderAPI::None: return MakeShared<TextureNull>();
 	case RenderAPI::GL: return MakeShared<TextureGL>();
 	}
 	ASSERT(false, "Render API not supported");
@@ -18,6 +20,7 @@ TexturePtr Texture::Create(const Path& path)
 {
 	switch(RenderDevice::GetAPI())
 	{
+	case RenderAPI::None: return MakeShared<TextureNull>(path);
 	case RenderAPI::GL: return MakeShared<TextureGL>(path);
 	}
 	ASSERT(false, "Render API not supported");
@@ -29,6 +32,8 @@ TexturePtr Texture::Create(
 {
 	switch(RenderDevice::GetAPI())
 	{
+	case RenderAPI::None:
+		return MakeShared<TextureNull>(width, height, filter, wrap, border);
 	case RenderAPI::GL:
 		return MakeShared<TextureGL>(width, height, filter, wrap, border);
 	}
@@ -36,6 +41,47 @@ TexturePtr Texture::Create(
 	return nullptr;
 }
 
+TexturePtr Texture::Create(
+        u32 width, u32 height, TextureFormat format, bool filter, WrapMode wrap)
+{
+	switch(RenderDevice::GetAPI())
+	{
+	case RenderAPI::None:
+		return MakeShared<TextureNull>(width, height, format, filter, wrap);
+	case RenderAPI::GL:
+		return MakeShared<TextureGL>(width, height, format, filter, wrap);
+	}
+	ASSERT(false, "Render API not supported");
+	return nullptr;
+}
+
+TexturePtr Texture::CreateArray(
+        u32 width, u32 height, u32 layers, bool filter, WrapMode wrap, Color border)
+{
+	switch(RenderDevice::GetAPI())
+	{
+	case RenderAPI::None:
+		return MakeShared<TextureNull>(width, height, layers, filter, wrap, border);
+	case RenderAPI::GL:
+		return MakeShared<TextureGL>(width, height, layers, filter, wrap, border);
+	}
+	ASSERT(false, "Render API not supported");
+	return nullptr;
+}
+
+TexturePtr Texture::CreateArray(const Path& path, u32 frame_width, u32 frame_height)
+{
+	switch(RenderDevice::GetAPI())
+	{
+	case RenderAPI::None:
+		return MakeShared<TextureNull>(path, frame_width, frame_height);
+	case RenderAPI::GL:
+		return MakeShared<TextureGL>(path, frame_width, frame_height);
+	}
+	ASSERT(false, "Render API not supported");
+	return nullptr;
+}
+
 bool Texture::operator==(const Texture& rhs) const
 {
 	return GetID() == rhs.GetID();
@@ -45,3 +91,29 @@ bool Texture::operator!=(const Texture& rhs) const
 {
 	return !operator==(rhs);
 }
+
+SubTexture::SubTexture(const TexturePtr& texture)
+        : Texture(texture),
+          Resolution(texture ? texture->GetResolution() : vec2ui {})
+{
+}
+
+SubTexture::SubTexture(const TexturePtr& texture,
+                       vec2              uvmin,
+                       vec2              uvmax,
+                       vec2ui            resolution)
+        : Texture(texture),
+          UVMin(uvmin),
+          UVMax(uvmax),
+          Resolution(resolution)
+{
+}
+
+SubTexture::SubTexture(const TexturePtr& texture, u32 layer)
+        : Texture(texture),
+          Resolution(texture->GetResolution()),
+          ArrayLayer(layer)
+{
+	ASSERT(texture->IsArray() && layer < texture->GetLayerCount(),
+	       "Layer out of array texture");
+}
@@ -0,0 +1,250 @@
+#include <TextureAtlas.hpp>
+
+#include <Logger.hpp>
+
+// RGBA pixels of the image file, null if it can't be read. stb_image is built
+// without stdio, the file is read here.
+static stbi_uc* LoadImage(const Path& path, int& width, int& height)
+{
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if(!in)
+		return nullptr;
+
+	Vector<u8> file(size_t(in.tellg()));
+	in.seekg(0, std::ios::beg);
+	in.read((char*)file.data(), std::streamsize(file.size()));
+	if(!in || file.empty())
+		return nullptr;
+
+	int channels;
+	return stbi_load_from_memory(
+	        file.data(), int(file.size()), &width, &height, &channels, 4);
+}
+
+TextureAtlas::TextureAtlas(
+        const RenderDevice& device, u32 page_size, u32 padding, u32 extrude, bool filter)
+        : mPageSize(page_size),
+          mPadding(padding),
+          mExtrude(extrude),
+          mFilter(filter)
+{
+	const RenderDeviceInfo& info = device.GetInfo();
+	u32 max_size = std::min(info.MaxTextureWidth, info.MaxTextureHeight);
+
+	if(mPageSize > max_size)
+	{
+		WARN("Atlas page size %u exceeds max texture size, using %u",
+		     mPageSize,
+		     max_size);
+		mPageSize = max_size;
+	}
+}
+
+SubTexture TextureAtlas::Add(const Path& path)
+{
+	int w, h;
+
+	stbi_uc* raw = LoadImage(path, w, h);
+	if(!raw)
+	{
+		ERROR("Could not load image %s", path.filename().generic_string());
+		return {};
+	}
+
+	SubTexture r = Add(raw, u32(w), u32(h));
+	stbi_image_free(raw);
+	return r;
+}
+
+Vector<SubTexture> TextureAtlas::Add(const Vector<Path>& paths)
+{
+	struct Image
+	{
+		stbi_uc* Pixels;
+		u32      Width;
+		u32      Height;
+	};
+
+	Vector<Image> images(paths.size());
+	Vector<u32>   order(paths.size());
+
+	for(u32 i = 0; i < paths.size(); ++i)
+	{
+		int w = 0, h = 0;
+
+		images[i].Pixels = LoadImage(paths[i], w, h);
+		images[i].Width  = u32(w);
+		images[i].Height = u32(h);
+		order[i]         = i;
+
+		if(!images[i].Pixels)
+			ERROR("Could not load image %s", paths[i].filename().generic_string());
+	}
+
+	std::stable_sort(order.begin(),
+	                 order.end(),
+	                 [&images](u32 a, u32 b)
+	                 {
+		                 return images[a].Height > images[b].Height;
+	                 });
+
+	Vector<SubTexture> r(paths.size());
+	for(u32 i : order)
+	{
+		if(images[i].Pixels)
+		{
+			r[i] = Add(images[i].Pixels, images[i].Width, images[i].Height);
+			stbi_image_free(images[i].Pixels);
+		}
+	}
+
+	return r;
+}
+
+SubTexture TextureAtlas::Add(const u8* pixels, u32 width, u32 height)
+{
+	const u32 border = mExtrude + mPadding;
+	const u32 cw     = width + 2 * mExtrude;  // cell size, extruded image
+	const u32 ch     = height + 2 * mExtrude;
+
+	if(width + 2 * border > mPageSize || height + 2 * border > mPageSize)
+	{
+		WARN("Image %ux%u does not fit in an atlas page, using its own texture",
+		     width,
+		     height);
+		TexturePtr t = Texture::Create(width, height, mFilter, WrapMode::Clamp);
+		t->SetData(pixels, size_t(width) * height * 4);
+		return SubTexture(t);
+	}
+
+	// First page with room, a new page otherwise
+	vec2ui position;
+	u32    page = 0;
+	while(page < mPageSkylines.size() &&
+	      !Insert(mPageSkylines[page], width + 2 * border, height + 2 * border, position))
+		++page;
+
+	if(page == mPageSkylines.size())
+	{
+		AddPage();
+		Insert(mPageSkylines[page], width + 2 * border, height + 2 * border, position);
+	}
+
+	// Copy the image with its border pixels repeated mExtrude times
+	mCell.resize(size_t(cw) * ch * 4);
+	for(u32 y = 0; y < ch; ++y)
+	{
+		u32 sy = std::clamp(i32(y) - i32(mExtrude), 0, i32(height) - 1);
+		for(u32 x = 0; x < cw; ++x)
+		{
+			u32 sx = std::clamp(i32(x) - i32(mExtrude), 0, i32(width) - 1);
+			std::memcpy(&mCell[(size_t(y) * cw + x) * 4],
+			            &pixels[(size_t(sy) * width + sx) * 4],
+			            4);
+		}
+	}
+
+	mPageTextures[page]->SetSubData(
+	        mCell.data(), position.x + mPadding, position.y + mPadding, cw, ch);
+
+	vec2 uvmin = vec2(position + border) / float(mPageSize);
+	vec2 uvmax = vec2(position + border + vec2ui {width, height}) / float(mPageSize);
+	return {mPageTextures[page], uvmin, uvmax, {width, height}};
+}
+
+bool TextureAtlas::Fit(
+        const Skyline& skyline, u32 index, u32 width, u32 height, u32& y) const
+{
+	if(skyline[index].X + width > mPageSize)
+		return false;
+
+	// The rectangle rests on the highest node it spans
+	u32 remaining = width;
+	y             = 0;
+	for(u32 i = index; remaining > 0; ++i)
+	{
+		y = std::max(y, skyline[i].Y);
+		if(y + height > mPageSize)
+			return false;
+		remaining -= std::min(remaining, skyline[i].Width);
+	}
+	return true;
+}
+
+bool TextureAtlas::Insert(Skyline& skyline, u32 width, u32 height, vec2ui& position)
+{
+	auto best_index = u32(skyline.size());
+	u32  best_top   = ~0u;
+	u32  best_width = ~0u;
+
+	// Bottom-left: lowest resulting top edge, then the narrowest node
+	for(u32 i = 0; i < skyline.size(); ++i)
+	{
+		u32 y;
+		if(!Fit(skyline, i, width, height, y))
+			continue;
+
+		u32 top = y + height;
+		if(top < best_top || (top == best_top && skyline[i].Width < best_width))
+		{
+			best_index = i;
+			best_top   = top;
+			best_width = skyline[i].Width;
+			position   = {skyline[i].X, y};
+		}
+	}
+
+	if(best_index == skyline.size())
+		return false;
+
+	skyline.insert(skyline.begin() + best_index, {position.x, best_top, width});
+
+	// Cut the nodes the new one covers
+	for(u32 i = best_index + 1; i < skyline.size();)
+	{
+		u32 end = skyline[i - 1].X + skyline[i - 1].Width;
+		if(skyline[i].X >= end)
+			break;
+
+		u32 shrink = end - skyline[i].X;
+		if(skyline[i].Width <= shrink)
+		{
+			skyline.erase(skyline.begin() + i);
+			continue;
+		}
+
+		skyline[i].X     += shrink;
+		skyline[i].Width -= shrink;
+		break;
+	}
+
+	// Merge neighbours at the same height
+	for(u32 i = 0; i + 1 < skyline.size();)
+	{
+		if(skyline[i].Y == skyline[i + 1].Y)
+		{
+			skyline[i].Width += skyline[i + 1].Width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+			++i;
+	}
+
+	return true;
+}
+
+void TextureAtlas::AddPage()
+{
+	TexturePtr page = Texture::Create(mPageSize, mPageSize, mFilter, WrapMode::Clamp);
+
+	// storage starts undefined, clear it so padding is transparent
+	page->Clear();
+
+	mPageTextures.push_back(page);
+	mPageSkylines.push_back({{0, 0, mPageSize}});
+
+	TRACE("Atlas page %u created (%ux%u)",
+	      u32(mPageTextures.size()),
+	      mPageSize,
+	      mPageSize);
+}
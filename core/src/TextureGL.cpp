@@ -1,6 +1,26 @@
 #include <TextureGL.hpp>
 
 #include <Assert.hpp>
+#include <Logger.hpp>
+
+// RGBA pixels of the image file, null if it can't be read. stb_image is built
+// without stdio, the file is read here.
+static stbi_uc* LoadImage(const Path& path, int& width, int& height)
+{
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if(!in)
+		return nullptr;
+
+	Vector<u8> file(size_t(in.tellg()));
+	in.seekg(0, std::ios::beg);
+	in.read((char*)file.data(), std::streamsize(file.size()));
+	if(!in || file.empty())
+		return nullptr;
+
+	int channels;
+	return stbi_load_from_memory(
+	        file.data(), int(file.size()), &width, &height, &channels, 4);
+}
 
 TextureGL::TextureGL()
         : mDataFormat(GL_RGBA),
@@ -77,6 +97,129 @@ TextureGL::TextureGL(u32 width, u32 height, bool filter, WrapMode wrap, Color bo
 	SetWrapMode(wrap, border);
 }
 
+TextureGL::TextureGL(
+        u32 width, u32 height, TextureFormat format, bool filter, WrapMode wrap)
+        : mWidth(width),
+          mHeight(height)
+{
+	switch(format)
+	{
+	case TextureFormat::RGBA8:
+		mInternalFormat = GL_RGBA8;
+		mDataFormat     = GL_RGBA;
+		break;
+	case TextureFormat::RGB10A2:
+		mInternalFormat = GL_RGB10_A2;
+		mDataFormat     = GL_RGBA;
+		break;
+	case TextureFormat::RGBA16F:
+		mInternalFormat = GL_RGBA16F;
+		mDataFormat     = GL_RGBA;
+		mDataType       = GL_HALF_FLOAT;
+		break;
+	case TextureFormat::R8:
+		mInternalFormat = GL_R8;
+		mDataFormat     = GL_RED;
+		break;
+	}
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &mID);
+	glTextureStorage2D(mID, 1, mInternalFormat, (GLsizei)width, (GLsizei)height);
+	SetFilter(filter);
+	SetWrapMode(wrap);
+}
+
+TextureGL::TextureGL(
+        u32 width, u32 height, u32 layers, bool filter, WrapMode wrap, Color border)
+        : mWidth(width),
+          mHeight(height),
+          mLayers(layers),
+          mArray(true),
+          mDataFormat(GL_RGBA),
+          mInternalFormat(GL_RGBA8)
+{
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &mID);
+	glTextureStorage3D(mID,
+	                   1,
+	                   mInternalFormat,
+	                   (GLsizei)width,
+	                   (GLsizei)height,
+	                   (GLsizei)layers);
+	SetFilter(filter);
+	SetWrapMode(wrap, border);
+}
+
+TextureGL::TextureGL(const Path& path, u32 frame_width, u32 frame_height)
+        : mWidth(frame_width),
+          mHeight(frame_height),
+          mArray(true),
+          mDataFormat(GL_RGBA),
+          mInternalFormat(GL_RGBA8)
+{
+	const String name = path.filename().generic_string();
+
+	int      w = 0, h = 0;
+	stbi_uc* raw = nullptr;
+	if(frame_width == 0 || frame_height == 0)
+		ERROR("Frames of %s have no size", name);
+	else if(!(raw = LoadImage(path, w, h)))
+		ERROR("Could not load image %s", name);
+	else if(u32(w) < frame_width || u32(h) < frame_height)
+	{
+		ERROR("Frames of %s are larger than the image", name);
+		stbi_image_free(raw);
+		raw = nullptr;
+	}
+
+	// a single empty layer in place of a sheet that can't be used
+	if(!raw)
+	{
+		mWidth  = std::max(frame_width, 1u);
+		mHeight = std::max(frame_height, 1u);
+	}
+
+	u32 columns = raw ? u32(w) / frame_width : 1;
+	u32 rows    = raw ? u32(h) / frame_height : 1;
+	mLayers     = columns * rows;
+
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &mID);
+	glTextureStorage3D(mID,
+	                   1,
+	                   mInternalFormat,
+	                   (GLsizei)mWidth,
+	                   (GLsizei)mHeight,
+	                   (GLsizei)mLayers);
+
+	SetFilter(false);
+	SetWrapMode(WrapMode::Clamp);
+
+	if(!raw)
+		return;
+
+	// frames are read in place from the sheet, rows are w pixels apart
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, w);
+	for(u32 layer = 0; layer < mLayers; ++layer)
+	{
+		u32 x = (layer % columns) * frame_width;
+		u32 y = (layer / columns) * frame_height;
+
+		glTextureSubImage3D(mID,
+		                    0,
+		                    0,
+		                    0,
+		                    (GLint)layer,
+		                    (GLsizei)mWidth,
+		                    (GLsizei)mHeight,
+		                    1,
+		                    mDataFormat,
+		                    GL_UNSIGNED_BYTE,
+		                    raw + (size_t(y) * u32(w) + x) * 4);
+	}
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+	stbi_image_free(raw);
+}
+
 TextureGL::~TextureGL()
 {
 	glDeleteTextures(1, &mID);
@@ -89,8 +232,10 @@ void TextureGL::Bind(u32 slot) const
 
 size_t TextureGL::GetSize() const
 {
-	u32 bpp = mDataFormat == GL_RGBA ? 4 : 3;
-	return size_t(mWidth) * mHeight * bpp;
+	u32 bpp = mDataFormat == GL_RGBA ? 4 : mDataFormat == GL_RGB ? 3 : 1;
+	if(mDataType == GL_HALF_FLOAT)
+		bpp *= 2;
+	return size_t(mWidth) * mHeight * mLayers * bpp;
 }
 
 vec2ui TextureGL::GetResolution() const
@@ -108,6 +253,16 @@ u32 TextureGL::GetHeight() const
 	return mHeight;
 }
 
+bool TextureGL::IsArray() const
+{
+	return mArray;
+}
+
+u32 TextureGL::GetLayerCount() const
+{
+	return mLayers;
+}
+
 bool TextureGL::IsFiltered() const
 {
 	return mFiltered;
@@ -171,6 +326,23 @@ void TextureGL::SetWrapMode(WrapMode wrap, Color border)
 void TextureGL::SetData(const void* data, size_t size)
 {
 	ASSERT(size == GetSize(), "Incorrect texture size");
+
+	if(mArray)
+	{
+		glTextureSubImage3D(mID,
+		                    0,
+		                    0,
+		                    0,
+		                    0,
+		                    (GLsizei)mWidth,
+		                    (GLsizei)mHeight,
+		                    (GLsizei)mLayers,
+		                    mDataFormat,
+		                    mDataType,
+		                    data);
+		return;
+	}
+
 	glTextureSubImage2D(mID,
 	                    0,
 	                    0,
@@ -178,10 +350,47 @@ void TextureGL::SetData(const void* data, size_t size)
 	                    (GLsizei)mWidth,
 	                    (GLsizei)mHeight,
 	                    mDataFormat,
-	                    GL_UNSIGNED_BYTE,
+	                    mDataType,
 	                    data);
 }
 
+void TextureGL::SetSubData(const void* data, u32 x, u32 y, u32 width, u32 height)
+{
+	ASSERT(!mArray, "Use SetLayerData for array textures");
+	ASSERT(x + width <= mWidth && y + height <= mHeight, "Region out of texture");
+	glTextureSubImage2D(mID,
+	                    0,
+	                    (GLint)x,
+	                    (GLint)y,
+	                    (GLsizei)width,
+	                    (GLsizei)height,
+	                    mDataFormat,
+	                    mDataType,
+	                    data);
+}
+
+void TextureGL::SetLayerData(const void* data, u32 layer)
+{
+	ASSERT(mArray && layer < mLayers, "Layer out of array texture");
+	glTextureSubImage3D(mID,
+	                    0,
+	                    0,
+	                    0,
+	                    (GLint)layer,
+	                    (GLsizei)mWidth,
+	                    (GLsizei)mHeight,
+	                    1,
+	                    mDataFormat,
+	                    mDataType,
+	                    data);
+}
+
+void TextureGL::Clear()
+{
+	// null data fills with zeros, every layer of an array at once
+	glClearTexImage(mID, 0, mDataFormat, mDataType, nullptr);
+}
+
 u32 TextureGL::GetID() const
 {
 	return mID;
@@ -0,0 +1,188 @@
+#include <TextureNull.hpp>
+
+#include <Assert.hpp>
+#include <Logger.hpp>
+#include <RenderDeviceNull.hpp>
+
+// Size of the image from its header, the pixels are not needed. stb_image is
+// built without stdio, the file is read here.
+static bool ReadImageSize(const Path& path, int& w, int& h, int& c)
+{
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	Vector<u8>    file(in ? size_t(in.tellg()) : 0);
+	in.seekg(0, std::ios::beg);
+	in.read((char*)file.data(), std::streamsize(file.size()));
+
+	if(in && !file.empty() &&
+	   stbi_info_from_memory(file.data(), int(file.size()), &w, &h, &c))
+		return true;
+
+	ERROR("Could not read image %s", path.filename().generic_string());
+	w = h = c = 1;
+	return false;
+}
+
+TextureNull::TextureNull()
+        : mID(RenderDeviceNull::GenerateID())
+{
+	// a white pixel
+	RenderDeviceNull::Record(NullCommandType::UploadTexture, mID, 4);
+}
+
+TextureNull::TextureNull(const Path& path)
+        : mID(RenderDeviceNull::GenerateID())
+{
+	int w, h, c;
+	ReadImageSize(path, w, h, c);
+
+	mWidth     = u32(w);
+	mHeight    = u32(h);
+	mPixelSize = c == 4 ? 4 : c == 3 ? 3 : 1;
+	RenderDeviceNull::Record(NullCommandType::UploadTexture, mID, u32(GetSize()));
+}
+
+TextureNull::TextureNull(u32 width, u32 height, bool filter, WrapMode wrap, Color)
+        : mID(RenderDeviceNull::GenerateID()),
+          mWidth(width),
+          mHeight(height),
+          mFiltered(filter),
+          mWrapMode(wrap)
+{
+}
+
+TextureNull::TextureNull(
+        u32 width, u32 height, TextureFormat format, bool filter, WrapMode wrap)
+        : mID(RenderDeviceNull::GenerateID()),
+          mWidth(width),
+          mHeight(height),
+          mPixelSize(format == TextureFormat::R8        ? 1
+                     : format == TextureFormat::RGBA16F ? 8
+                                                        : 4),
+          mFiltered(filter),
+          mWrapMode(wrap)
+{
+}
+
+TextureNull::TextureNull(
+        u32 width, u32 height, u32 layers, bool filter, WrapMode wrap, Color)
+        : mID(RenderDeviceNull::GenerateID()),
+          mWidth(width),
+          mHeight(height),
+          mLayers(layers),
+          mArray(true),
+          mFiltered(filter),
+          mWrapMode(wrap)
+{
+}
+
+TextureNull::TextureNull(const Path& path, u32 frame_width, u32 frame_height)
+        : mID(RenderDeviceNull::GenerateID()),
+          mWidth(frame_width),
+          mHeight(frame_height),
+          mArray(true),
+          mWrapMode(WrapMode::Clamp)
+{
+	int w, h, c;
+	if(frame_width == 0 || frame_height == 0)
+	{
+		ERROR("Frames of %s have no size", path.filename().generic_string());
+		mWidth  = std::max(frame_width, 1u);
+		mHeight = std::max(frame_height, 1u);
+	}
+	else if(ReadImageSize(path, w, h, c))
+	{
+		if(u32(w) >= frame_width && u32(h) >= frame_height)
+			mLayers = (u32(w) / frame_width) * (u32(h) / frame_height);
+		else
+			ERROR("Frames of %s are larger than the image",
+			      path.filename().generic_string());
+	}
+
+	RenderDeviceNull::Record(NullCommandType::UploadTexture, mID, u32(GetSize()));
+}
+
+void TextureNull::Bind(u32) const
+{
+	RenderDeviceNull::Record(NullCommandType::BindTexture, mID, 0);
+}
+
+size_t TextureNull::GetSize() const
+{
+	return size_t(mWidth) * mHeight * mLayers * mPixelSize;
+}
+
+vec2ui TextureNull::GetResolution() const
+{
+	return {mWidth, mHeight};
+}
+
+u32 TextureNull::GetWidth() const
+{
+	return mWidth;
+}
+
+u32 TextureNull::GetHeight() const
+{
+	return mHeight;
+}
+
+bool TextureNull::IsArray() const
+{
+	return mArray;
+}
+
+u32 TextureNull::GetLayerCount() const
+{
+	return mLayers;
+}
+
+bool TextureNull::IsFiltered() const
+{
+	return mFiltered;
+}
+
+void TextureNull::SetFilter(bool enable)
+{
+	mFiltered = enable;
+}
+
+WrapMode TextureNull::GetWrapMode() const
+{
+	return mWrapMode;
+}
+
+void TextureNull::SetWrapMode(WrapMode wrap, Color)
+{
+	mWrapMode = wrap;
+}
+
+void TextureNull::SetData(const void*, size_t size)
+{
+	ASSERT(size == GetSize(), "Incorrect texture size");
+	RenderDeviceNull::Record(NullCommandType::UploadTexture, mID, u32(size));
+}
+
+void TextureNull::SetSubData(const void*, u32 x, u32 y, u32 width, u32 height)
+{
+	ASSERT(!mArray, "Use SetLayerData for array textures");
+	ASSERT(x + width <= mWidth && y + height <= mHeight, "Region out of texture");
+	RenderDeviceNull::Record(
+	        NullCommandType::UploadTexture, mID, width * height * mPixelSize);
+}
+
+void TextureNull::SetLayerData(const void*, u32 layer)
+{
+	ASSERT(mArray && layer < mLayers, "Layer out of array texture");
+	RenderDeviceNull::Record(
+	        NullCommandType::UploadTexture, mID, mWidth * mHeight * mPixelSize);
+}
+
+void TextureNull::Clear()
+{
+	RenderDeviceNull::Record(NullCommandType::Clear, mID, 0);
+}
+
+u32 TextureNull::GetID() const
+{
+	return mID;
+}
@@ -0,0 +1,54 @@
+#include <TextureSlots.hpp>
+
+std::atomic<u32> TextureSlots::sStamp {0};
+
+TextureSlots::TextureSlots(u32 textures, u32 arrays)
+        : mSlots(textures + arrays, nullptr),
+          mTextureSlots(textures),
+          mTextureIndex(0),
+          mArrayIndex(textures),
+          mStamp(++sStamp)
+{
+}
+
+bool TextureSlots::Acquire(Texture* texture, u32& slot)
+{
+	if(texture->mBatchStamp != mStamp)
+	{
+		bool array = texture->IsArray();
+		u32& next  = array ? mArrayIndex : mTextureIndex;
+		u32  end   = array ? u32(mSlots.size()) : mTextureSlots;
+		if(next == end)
+			return false;
+
+		texture->mBatchStamp = mStamp;
+		texture->mBatchSlot  = next;
+		mSlots[next++]       = texture;
+	}
+
+	slot = texture->mBatchSlot;
+	return true;
+}
+
+void TextureSlots::Reset()
+{
+	// a new stamp invalidates the slot of every texture at once
+	mStamp        = ++sStamp;
+	mTextureIndex = 0;
+	mArrayIndex   = mTextureSlots;
+}
+
+bool TextureSlots::IsFull() const
+{
+	return mTextureIndex == mTextureSlots || mArrayIndex == mSlots.size();
+}
+
+u32 TextureSlots::Bind() const
+{
+	for(u32 i = 0; i < mTextureIndex; ++i)
+		mSlots[i]->Bind(i);
+	for(u32 i = mTextureSlots; i < mArrayIndex; ++i)
+		mSlots[i]->Bind(i);
+
+	return mTextureIndex + mArrayIndex - mTextureSlots;
+}
@@ -0,0 +1,17 @@
+#include <TimerQuery.hpp>
+
+#include <Assert.hpp>
+#include <RenderDevice.hpp>
+#include <TimerQueryGL.hpp>
+#include <TimerQueryNull.hpp>
+
+TimerQueryPtr TimerQuery::Create()
+{
+	switch(RenderDevice::GetAPI())
+	{
+	case RenderAPI::None: return MakeShared<TimerQueryNull>();
+	case RenderAPI::GL: return MakeShared<TimerQueryGL>();
+	}
+	ASSERT(false, "Render API not supported");
+	return nullptr;
+}
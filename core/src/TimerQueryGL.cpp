@@ -0,0 +1,45 @@
+#include <TimerQueryGL.hpp>
+
+TimerQueryGL::TimerQueryGL()
+{
+	glGenQueries(1, &mID);
+}
+
+TimerQueryGL::~TimerQueryGL()
+{
+	glDeleteQueries(1, &mID);
+}
+
+void TimerQueryGL::Begin()
+{
+	glBeginQuery(GL_TIME_ELAPSED, mID);
+	mIssued = true;
+}
+
+void TimerQueryGL::End()
+{
+	glEndQuery(GL_TIME_ELAPSED);
+}
+
+void TimerQueryGL::Timestamp()
+{
+	glQueryCounter(mID, GL_TIMESTAMP);
+	mIssued = true;
+}
+
+bool TimerQueryGL::IsAvailable() const
+{
+	if(!mIssued)
+		return false;
+
+	GLint available = GL_FALSE;
+	glGetQueryObjectiv(mID, GL_QUERY_RESULT_AVAILABLE, &available);
+	return available == GL_TRUE;
+}
+
+u64 TimerQueryGL::GetResult() const
+{
+	GLuint64 result = 0;
+	glGetQueryObjectui64v(mID, GL_QUERY_RESULT, &result);
+	return result;
+}
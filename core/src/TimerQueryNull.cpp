@@ -0,0 +1,23 @@
+#include <TimerQueryNull.hpp>
+
+void TimerQueryNull::Begin()
+{
+	mIssued = true;
+}
+
+void TimerQueryNull::End() {}
+
+void TimerQueryNull::Timestamp()
+{
+	mIssued = true;
+}
+
+bool TimerQueryNull::IsAvailable() const
+{
+	return mIssued;
+}
+
+u64 TimerQueryNull::GetResult() const
+{
+	return 0;
+}
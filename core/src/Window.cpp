@@ -3,6 +3,11 @@
 #include <Assert.hpp>
 #include <RenderDevice.hpp>
 #include <WindowGLFW.hpp>
+#include <WindowNull.hpp>
+
+#if ENGINE_HEADLESS
+	#include <WindowEGL.hpp>
+#endif
 
 WindowSettings::WindowSettings(String title)
         : Title(std::move(title))
@@ -43,6 +48,22 @@ Window::Window(WindowSettings settings)
 
 WindowPtr Window::Create(const WindowSettings& settings)
 {
+	// nothing to show or to render with
+	if(RenderDevice::GetAPI() == RenderAPI::None)
+		return MakeUnique<WindowNull>(settings);
+
+	if(settings.Headless)
+	{
+#if ENGINE_HEADLESS
+		switch(RenderDevice::GetAPI())
+		{
+		case RenderAPI::GL: return MakeUnique<WindowEGL>(settings);
+		}
+#endif
+		ASSERT(false, "Headless windows need ENGINE_HEADLESS");
+		return nullptr;
+	}
+
 	switch(RenderDevice::GetAPI())
 	{
 	case RenderAPI::GL: return MakeUnique<WindowGLFW>(settings);
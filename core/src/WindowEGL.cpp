@@ -0,0 +1,180 @@
+#include <WindowEGL.hpp>
+
+#include <Assert.hpp>
+#include <Logger.hpp>
+
+// glad's copy of khrplatform.h shadows the system one and lacks this
+#ifndef KHRONOS_APIENTRY
+	#define KHRONOS_APIENTRY KHRONOS_GLAD_API_PTR
+#endif
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+static bool HasExtension(const char* extensions, const char* name)
+{
+	if(!extensions)
+		return false;
+
+	size_t      length = std::strlen(name);
+	const char* p      = extensions;
+	while((p = std::strstr(p, name)))
+	{
+		bool start = p == extensions || p[-1] == ' ';
+		bool end   = p[length] == ' ' || p[length] == '\0';
+		if(start && end)
+			return true;
+		++p;
+	}
+	return false;
+}
+
+static const EGLint sContextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION,
+                                            4,
+                                            EGL_CONTEXT_MINOR_VERSION,
+                                            6,
+                                            EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                                            EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+#ifdef ENGINE_DEBUG_BUILD
+                                            EGL_CONTEXT_OPENGL_DEBUG,
+                                            EGL_TRUE,
+#endif
+                                            EGL_NONE};
+
+static EGLDisplay GetDisplay()
+{
+	// Mesa's surfaceless platform needs neither a display server nor a GPU
+	const char* client = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	if(HasExtension(client, "EGL_MESA_platform_surfaceless"))
+	{
+		EGLDisplay display = eglGetPlatformDisplay(
+		        EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		if(display != EGL_NO_DISPLAY)
+			return display;
+	}
+
+	return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+WindowEGL::WindowEGL(const WindowSettings& settings)
+        : WindowNull(settings)
+{
+	EGLDisplay display = GetDisplay();
+	ASSERT(display != EGL_NO_DISPLAY, "No EGL display");
+
+	EGLint major, minor;
+	if(!eglInitialize(display, &major, &minor))
+	{
+		ERROR("EGL initialization failed (0x%x)", eglGetError());
+		return;
+	}
+	mDisplay = display;
+	eglBindAPI(EGL_OPENGL_API);
+
+	const EGLint config_attributes[] = {EGL_SURFACE_TYPE,
+	                                    EGL_PBUFFER_BIT,
+	                                    EGL_RENDERABLE_TYPE,
+	                                    EGL_OPENGL_BIT,
+	                                    EGL_RED_SIZE,
+	                                    8,
+	                                    EGL_GREEN_SIZE,
+	                                    8,
+	                                    EGL_BLUE_SIZE,
+	                                    8,
+	                                    EGL_ALPHA_SIZE,
+	                                    8,
+	                                    EGL_NONE};
+
+	EGLConfig config;
+	EGLint    count = 0;
+	eglChooseConfig(display, config_attributes, &config, 1, &count);
+	ASSERT(count != 0, "No suitable EGL config");
+
+	mConfig = config;
+
+	mContext = eglCreateContext(display, config, EGL_NO_CONTEXT, sContextAttributes);
+	ASSERT(mContext != EGL_NO_CONTEXT, "Could not create an OpenGL 4.6 EGL context");
+
+	// Rendering goes to the render device's back buffer, the surface only
+	// exists because the context needs one without the extension
+	const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+	if(!HasExtension(extensions, "EGL_KHR_surfaceless_context"))
+	{
+		const EGLint surface_attributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+		mSurface = eglCreatePbufferSurface(display, config, surface_attributes);
+	}
+
+	eglMakeCurrent(display, mSurface, mSurface, mContext);
+
+	INFO("Headless EGL %d.%d context (%s)",
+	     major,
+	     minor,
+	     mSurface ? "pbuffer" : "surfaceless");
+}
+
+WindowEGL::~WindowEGL()
+{
+	if(!mDisplay)
+		return;
+
+	eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if(mSharedSurface)
+		eglDestroySurface(mDisplay, mSharedSurface);
+	if(mSharedContext)
+		eglDestroyContext(mDisplay, mSharedContext);
+	if(mSurface)
+		eglDestroySurface(mDisplay, mSurface);
+	if(mContext)
+		eglDestroyContext(mDisplay, mContext);
+	eglTerminate(mDisplay);
+}
+
+void* WindowEGL::GetHandle() const
+{
+	return mContext;
+}
+
+Window::ProcAddress WindowEGL::GetProcAddress(const char* name) const
+{
+	return eglGetProcAddress(name);
+}
+
+void WindowEGL::MakeContextCurrent()
+{
+	eglMakeCurrent(mDisplay, mSurface, mSurface, mContext);
+}
+
+void WindowEGL::MakeSharedContextCurrent()
+{
+	if(!mSharedContext)
+	{
+		mSharedContext =
+		        eglCreateContext(mDisplay, mConfig, mContext, sContextAttributes);
+		ASSERT(mSharedContext != EGL_NO_CONTEXT,
+		       "Could not create a shared context");
+
+		// a pbuffer can't be current on two threads, the shared context gets its
+		// own
+		if(mSurface)
+		{
+			const EGLint surface_attributes[] = {
+			        EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+			mSharedSurface =
+			        eglCreatePbufferSurface(mDisplay, mConfig, surface_attributes);
+		}
+	}
+
+	eglMakeCurrent(mDisplay, mSharedSurface, mSharedSurface, mSharedContext);
+}
+
+void WindowEGL::DetachContext()
+{
+	eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+void WindowEGL::SwapBuffers()
+{
+	// Nothing is presented. Waiting for the frame keeps the CPU from running
+	// ahead, so frame times include the GPU work like a swap without vsync.
+	glFinish();
+}
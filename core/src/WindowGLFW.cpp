@@ -1,5 +1,6 @@
 #include <WindowGLFW.hpp>
 
+#include <Assert.hpp>
 #include <Logger.hpp>
 
 u32 WindowGLFW::sWindowCount = 0;
@@ -87,7 +88,9 @@ static void ErrorCallback(int code, const char* desc)
 
 WindowGLFW::WindowGLFW(const WindowSettings& settings)
         : Window(settings),
-          mWindow(nullptr)
+          mWindow(nullptr),
+          mSharedWindow(nullptr),
+          mSwapIntervalPending(false)
 {
 	glfwSetErrorCallback(ErrorCallback);
 
@@ -147,6 +150,8 @@ WindowGLFW::~WindowGLFW()
 		return;
 	}
 
+	if(mSharedWindow)
+		glfwDestroyWindow(mSharedWindow);
 	glfwDestroyWindow(mWindow);
 	mWindow = nullptr;
 	--sWindowCount;
@@ -277,7 +282,13 @@ VSyncMode WindowGLFW::GetVSyncMode() const
 void WindowGLFW::SetVSyncMode(VSyncMode mode)
 {
 	mSettings.VSync = mode;
-	glfwSwapInterval(int(mode));
+
+	// the interval belongs to the context, with a render thread it is set there
+	// before the next swap
+	if(glfwGetCurrentContext() == mWindow)
+		glfwSwapInterval(int(mode));
+	else
+		mSwapIntervalPending = true;
 }
 
 u32 WindowGLFW::GetMSAA() const
@@ -359,8 +370,40 @@ void* WindowGLFW::GetHandle() const
 	return mWindow;
 }
 
+Window::ProcAddress WindowGLFW::GetProcAddress(const char* name) const
+{
+	return glfwGetProcAddress(name);
+}
+
+void WindowGLFW::MakeContextCurrent()
+{
+	glfwMakeContextCurrent(mWindow);
+}
+
+void WindowGLFW::MakeSharedContextCurrent()
+{
+	if(!mSharedWindow)
+	{
+		// same context hints as the window, never shown
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		mSharedWindow = glfwCreateWindow(1, 1, "", nullptr, mWindow);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+		ASSERT(mSharedWindow, "Could not create a shared context");
+	}
+
+	glfwMakeContextCurrent(mSharedWindow);
+}
+
+void WindowGLFW::DetachContext()
+{
+	glfwMakeContextCurrent(nullptr);
+}
+
 void WindowGLFW::SwapBuffers()
 {
+	if(mSwapIntervalPending.exchange(false))
+		glfwSwapInterval(int(mSettings.VSync));
+
 	glfwSwapBuffers(mWindow);
 }
 
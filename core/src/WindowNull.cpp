@@ -0,0 +1,154 @@
+#include <WindowNull.hpp>
+
+WindowNull::WindowNull(const WindowSettings& settings)
+        : Window(settings)
+{
+}
+
+const String& WindowNull::GetTitle() const
+{
+	return mSettings.Title;
+}
+
+void WindowNull::SetTitle(const String& title)
+{
+	mSettings.Title = title;
+}
+
+u32 WindowNull::GetWidth() const
+{
+	return mSettings.Resolution.x;
+}
+
+u32 WindowNull::GetHeight() const
+{
+	return mSettings.Resolution.y;
+}
+
+vec2ui WindowNull::GetResolution() const
+{
+	return mSettings.Resolution;
+}
+
+void WindowNull::SetWidth(u32 width)
+{
+	SetResolution({width, mSettings.Resolution.y});
+}
+
+void WindowNull::SetHeight(u32 height)
+{
+	SetResolution({mSettings.Resolution.x, height});
+}
+
+void WindowNull::SetResolution(vec2ui resolution)
+{
+	mSettings.Resolution = resolution;
+	FramebufferSignal(resolution);
+	SizeSignal(resolution);
+}
+
+vec2ui WindowNull::GetPosition() const
+{
+	return mSettings.Position;
+}
+
+void WindowNull::SetPosition(vec2ui pos)
+{
+	mSettings.Position = pos;
+}
+
+WindowMode WindowNull::GetWindowMode() const
+{
+	return mSettings.Mode;
+}
+
+bool WindowNull::IsFullscreen() const
+{
+	return mSettings.Mode != WindowMode::Windowed;
+}
+
+void WindowNull::SetWindowMode(WindowMode mode)
+{
+	mSettings.Mode = mode;
+}
+
+VSyncMode WindowNull::GetVSyncMode() const
+{
+	return VSyncMode::Immediate;
+}
+
+void WindowNull::SetVSyncMode(VSyncMode) {}
+
+u32 WindowNull::GetMSAA() const
+{
+	return mSettings.MSAA;
+}
+
+void WindowNull::SetMSAA(u32 samples)
+{
+	mSettings.MSAA = samples;
+}
+
+bool WindowNull::IsSRGB() const
+{
+	return mSettings.SRGB;
+}
+
+void WindowNull::SetSRGB(bool srgb)
+{
+	mSettings.SRGB = srgb;
+}
+
+bool WindowNull::IsResizable() const
+{
+	return mSettings.Resizable;
+}
+
+void WindowNull::SetResizable(bool resizable)
+{
+	mSettings.Resizable = resizable;
+}
+
+bool WindowNull::IsBorderless() const
+{
+	return mSettings.Borderless;
+}
+
+void WindowNull::SetBorderless(bool borderless)
+{
+	mSettings.Borderless = borderless;
+}
+
+bool WindowNull::IsFocused() const
+{
+	return true;
+}
+
+void WindowNull::SetFocus(bool) {}
+
+bool WindowNull::IsHidden() const
+{
+	return true;
+}
+
+void WindowNull::SetHidden(bool) {}
+
+void* WindowNull::GetHandle() const
+{
+	return nullptr;
+}
+
+Window::ProcAddress WindowNull::GetProcAddress(const char*) const
+{
+	return nullptr;
+}
+
+void WindowNull::MakeContextCurrent() {}
+
+void WindowNull::MakeSharedContextCurrent() {}
+
+void WindowNull::DetachContext() {}
+
+void WindowNull::SwapBuffers() {}
+
+void WindowNull::PollEvents() {}
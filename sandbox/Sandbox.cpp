@@ -75,17 +75,26 @@ void Sandbox::Initialize()
 
 void Sandbox::Update(double dt)
 {
-	mRenderDevice->Clear();
+	mRenderer->Clear();
 
-	auto& t    = player.GetComponent<TransformComponent>();
-	t.Position += pos * dt;
+	player.PatchComponent<TransformComponent>([this, dt](TransformComponent& t)
+	                                          { t.Position += pos * dt; });
 
 	time += dt;
 	if(time > 1.0f)
 	{
-		INFO("%u,  %u,  %.4f,  %.1f",
-		     mRenderer->GetFrameStats().DrawCalls,
-		     mRenderer->GetFrameStats().QuadCount,
+		const FrameStats& stats = mRenderer->GetStatsHistory(0);
+		INFO("%u/%u,  %u/%u,  %u/%u,  flushes %u/%u/%u,  GPU %.3f,  %.4f,  %.1f",
+		     stats.DrawCalls,
+		     stats.Batches,
+		     stats.QuadCount,
+		     stats.ShapeCount,
+		     stats.VisibleCount,
+		     stats.CulledCount,
+		     stats.TextureFlushes,
+		     stats.CapacityFlushes,
+		     stats.StateFlushes,
+		     stats.GPUTime,
 		     dt,
 		     1.0f / dt);
 		time = 0.0f;
@@ -128,6 +137,18 @@ bool Sandbox::KeyboardInput(Key press, Key release)
 		mWindow->SetWindowMode(mode);
 	}
 
+	if(press == Key::F2)
+		BenchmarkTextureSlots();
+
+	if(press == Key::F3)
+		BenchmarkBulkSprites();
+
+	if(press == Key::F4)
+		BenchmarkVertexFormats();
+
+	if(press == Key::F5)
+		CheckTextureSlotOverflow();
+
 	if(press == Key::Escape)
 		Terminate();
 
@@ -159,3 +180,145 @@ bool Sandbox::ScrollInput(vec2 offset)
 {
 	return true;
 }
+
+void Sandbox::BenchmarkTextureSlots()
+{
+	const u32 quads = 1000000;
+
+	TexturePtr         white = Texture::Create();
+	Vector<TexturePtr> textures;
+	for(u32 i = 0; i < 64; ++i)
+		textures.push_back(Texture::Create(1, 1));
+
+	INFO("textures,  ns/quad,  batches");
+
+	for(u32 count : {1u, 2u, 4u, 8u, 16u, 31u, 64u})
+	{
+		// the slot lookup of Renderer::EmitQuad alone, a full table starts the
+		// next batch with the white texture in slot 0
+		TextureSlots slots(mRenderer->GetTextureSlots(), mRenderer->GetArraySlots());
+		u32          slot    = 0;
+		u32          batches = 1;
+		slots.Acquire(white.get(), slot);
+
+		Timer timer;
+		for(u32 i = 0; i < quads; ++i)
+		{
+			Texture* texture = textures[i % count].get();
+			if(!slots.Acquire(texture, slot))
+			{
+				slots.Reset();
+				slots.Acquire(white.get(), slot);
+				slots.Acquire(texture, slot);
+				++batches;
+			}
+		}
+
+		INFO("%u,  %.2f,  %u", count, timer.NanoSeconds() / quads, batches);
+	}
+}
+
+void Sandbox::BenchmarkBulkSprites()
+{
+	const u32 count = 100000;
+
+	Vector<SpriteInstance> sprites(count);
+	for(u32 i = 0; i < count; ++i)
+	{
+		// zero sized, nothing is rasterized, only the CPU side is measured
+		sprites[i].Position = vec2 {float(i % 640), float(i / 640)};
+		sprites[i].Size     = vec2 {0.0f};
+		sprites[i].Rotation = float(i % 360);
+		sprites[i].Color    = Color::WHITE;
+		sprites[i].Layer    = 0;
+		sprites[i].Sprite   = nullptr;
+	}
+
+	Timer timer;
+	mRenderer->DrawBegin(Transform());
+	for(const SpriteInstance& s : sprites)
+	{
+		mRenderer->SetColor(s.Color);
+		mRenderer->DrawRotatedQuad(s.Position, s.Size, s.Rotation);
+	}
+	mRenderer->DrawEnd();
+	mRenderer->Sync();
+	double single = timer.NanoSeconds() / count;
+
+	timer.Reset();
+	mRenderer->DrawBegin(Transform());
+	mRenderer->DrawQuads(sprites.data(), count);
+	mRenderer->DrawEnd();
+	mRenderer->Sync();
+	double bulk = timer.NanoSeconds() / count;
+
+	INFO("DrawRotatedQuad: %.2f ns/sprite, DrawQuads: %.2f ns/sprite (%.2fx)",
+	     single,
+	     bulk,
+	     single / bulk);
+}
+
+void Sandbox::BenchmarkVertexFormats()
+{
+	const u32 count = 50000;
+
+	INFO("layout,  vertex bytes,  ns/primitive");
+
+	// these renderers draw on this thread, with the device the render thread uses
+	mRenderer->Sync();
+
+	for(bool compact : {false, true})
+	{
+		RendererSettings settings = mRendererSettings;
+		settings.Mode             = BatchMode::Vertex;
+		settings.CompactVertices  = compact;
+		Renderer renderer(mRenderDevice, settings);
+
+		// tiny primitives, rasterization costs next to nothing
+		Timer timer;
+		renderer.DrawBegin(Transform());
+		for(u32 i = 0; i < count; ++i)
+		{
+			vec2 position {float(i % 640), float(i / 640)};
+			renderer.DrawRotatedQuad(position, vec2 {0.1f}, float(i % 360));
+			renderer.DrawCircle(position, 0.1f);
+		}
+		renderer.DrawEnd();
+
+		INFO("%s,  %u,  %.2f",
+		     compact ? "compact" : "full",
+		     renderer.GetFrameStats().VertexBytes,
+		     timer.NanoSeconds() / (2 * count));
+	}
+}
+
+void Sandbox::CheckTextureSlotOverflow()
+{
+	// this renderer draws on this thread, with the device the render thread uses
+	mRenderer->Sync();
+
+	RendererSettings settings = mRendererSettings;
+	settings.MaxQuads         = 64;
+	settings.MaxQuadsLimit    = 64;
+	settings.MultiDraw        = true;
+	Renderer renderer(mRenderDevice, settings);
+
+	// every slot but the white texture's
+	Vector<TexturePtr> textures;
+	for(u32 i = 1; i < renderer.GetTextureSlots(); ++i)
+		textures.push_back(Texture::Create(1, 1));
+	TexturePtr last = Texture::Create(1, 1);
+
+	// a full region over all of them, then one texture more
+	renderer.DrawBegin(Transform());
+	for(u32 i = 0; i < settings.MaxQuads; ++i)
+		renderer.DrawQuad(textures[i % textures.size()], vec2 {0.0f}, vec2 {0.0f});
+	renderer.DrawQuad(last, vec2 {0.0f}, vec2 {0.0f});
+	renderer.DrawEnd();
+
+	const FrameStats& stats = renderer.GetFrameStats();
+	if(stats.DrawCalls == 2)
+		INFO("Texture slot overflow: passed");
+	else
+		ERROR("Texture slot overflow: %u draw calls, expected 2", stats.DrawCalls);
+}
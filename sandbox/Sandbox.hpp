@@ -14,6 +14,16 @@ public:
 	bool CursorInput(vec2 position);
 	bool ScrollInput(vec2 offset);
 
+	// Per quad CPU cost as the number of distinct textures per batch grows
+	void BenchmarkTextureSlots();
+	// DrawRotatedQuad per sprite against a single DrawQuads call
+	void BenchmarkBulkSprites();
+	// Vertex bytes uploaded per frame with the full and the compact layouts
+	void BenchmarkVertexFormats();
+	// A texture drawn after a stream region filled the texture slots must start
+	// a new draw call instead of taking a slot of the full batch
+	void CheckTextureSlotOverflow();
+
 private:
 	float  time {0.0f};
 	vec2   pos;
@@ -1,31 +1,88 @@
 #type vertex
 #version 460 core
 
+// Variants, see BatchMode: INSTANCED reads a quad per instance, PULLING reads
+// the quads from a storage buffer, neither of them has vertices
+
+#if defined(INSTANCED)
+// Instance Attributes
+layout (location = 0) in vec3  aRow0;    // model transform, first row
+layout (location = 1) in vec3  aRow1;    // model transform, second row
+layout (location = 2) in vec4  aUVRect;  // min uv in xy, max uv in zw
+layout (location = 3) in vec4  aColor;
+layout (location = 4) in float aTexID;
+layout (location = 5) in float aArrayLayer;
+#elif defined(PULLING)
+// QuadInstance, scalars only so std430 lays it out like the C++ struct
+struct Quad
+{
+	float Model[6];   // model transform, row major
+	float UVRect[4];  // min uv, max uv
+	uint  Color;
+	float TexID;
+	float ArrayLayer;
+};
+
+layout (std430, binding = 0) readonly buffer Quads
+{
+	Quad uQuads[];
+};
+#else
 // Vertex Attributes
 layout (location = 0) in vec2  aPosition;
 layout (location = 1) in vec2  aUV;
 layout (location = 2) in vec4  aColor;
 layout (location = 3) in float aTexID;
+layout (location = 4) in float aArrayLayer;
+#endif
 
-// View-Projection matrix
-uniform mat3x2 uViewProjection;
+#include "include/Frame.glsl"
 
 struct VertexOutput
 {
 	vec2  UV;
 	vec4  Color;
 	float TexID;
+	float ArrayLayer;
 };
 
 layout (location = 0) out VertexOutput Output;
 
+#include "include/Corners.glsl"
+
 void main()
 {
+#if defined(INSTANCED)
+	vec2 corner   = cCorners[gl_VertexID];
+	vec3 local    = vec3(corner - 0.5f, 1.0f);
+	vec2 position = vec2(dot(aRow0, local), dot(aRow1, local));
+
+	Output.UV = mix(aUVRect.xy, aUVRect.zw, corner);
+	Output.Color = aColor;
+	Output.TexID = aTexID;
+	Output.ArrayLayer = aArrayLayer;
+#elif defined(PULLING)
+	Quad q = uQuads[gl_VertexID / 6];
+
+	vec2 corner   = cCorners[gl_VertexID % 6];
+	vec3 local    = vec3(corner - 0.5f, 1.0f);
+	vec2 position = vec2(dot(vec3(q.Model[0], q.Model[1], q.Model[2]), local),
+	                     dot(vec3(q.Model[3], q.Model[4], q.Model[5]), local));
+
+	Output.UV = mix(vec2(q.UVRect[0], q.UVRect[1]), vec2(q.UVRect[2], q.UVRect[3]), corner);
+	Output.Color = unpackUnorm4x8(q.Color);
+	Output.TexID = q.TexID;
+	Output.ArrayLayer = q.ArrayLayer;
+#else
+	vec2 position = aPosition;
+
 	Output.UV = aUV;
 	Output.Color = aColor;
 	Output.TexID = aTexID;
+	Output.ArrayLayer = aArrayLayer;
+#endif
 
-	gl_Position = vec4(uViewProjection * vec3(aPosition, 1.0f), 0.0f, 1.0f);
+	gl_Position = vec4(uViewProjection * vec3(position, 1.0f), 0.0f, 1.0f);
 }
 
 #type fragment
@@ -33,52 +90,19 @@ void main()
 
 layout(location = 0) out vec4 outColor;
 
-layout(binding = 0) uniform sampler2D uTextures[32];
+#include "include/Textures.glsl"
 
 struct VertexOutput
 {
 	vec2  UV;
 	vec4  Color;
 	float TexID;
+	float ArrayLayer;
 };
 
 layout (location = 0) in VertexOutput Input;
 
 void main()
 {
-	switch(int(Input.TexID))
-	{
-	case 0: outColor =  Input.Color * texture(uTextures[0],  Input.UV); break;
-	case 1: outColor =  Input.Color * texture(uTextures[1],  Input.UV); break;
-	case 2: outColor =  Input.Color * texture(uTextures[2],  Input.UV); break;
-	case 3: outColor =  Input.Color * texture(uTextures[3],  Input.UV); break;
-	case 4: outColor =  Input.Color * texture(uTextures[4],  Input.UV); break;
-	case 5: outColor =  Input.Color * texture(uTextures[5],  Input.UV); break;
-	case 6: outColor =  Input.Color * texture(uTextures[6],  Input.UV); break;
-	case 7: outColor =  Input.Color * texture(uTextures[7],  Input.UV); break;
-	case 8: outColor =  Input.Color * texture(uTextures[8],  Input.UV); break;
-	case 9: outColor =  Input.Color * texture(uTextures[9],  Input.UV); break;
-	case 10: outColor = Input.Color * texture(uTextures[10], Input.UV); break;
-	case 11: outColor = Input.Color * texture(uTextures[11], Input.UV); break;
-	case 12: outColor = Input.Color * texture(uTextures[12], Input.UV); break;
-	case 13: outColor = Input.Color * texture(uTextures[13], Input.UV); break;
-	case 14: outColor = Input.Color * texture(uTextures[14], Input.UV); break;
-	case 15: outColor = Input.Color * texture(uTextures[15], Input.UV); break;
-	case 16: outColor = Input.Color * texture(uTextures[16], Input.UV); break;
-	case 17: outColor = Input.Color * texture(uTextures[17], Input.UV); break;
-	case 18: outColor = Input.Color * texture(uTextures[18], Input.UV); break;
-	case 19: outColor = Input.Color * texture(uTextures[19], Input.UV); break;
-	case 20: outColor = Input.Color * texture(uTextures[20], Input.UV); break;
-	case 21: outColor = Input.Color * texture(uTextures[21], Input.UV); break;
-	case 22: outColor = Input.Color * texture(uTextures[22], Input.UV); break;
-	case 23: outColor = Input.Color * texture(uTextures[23], Input.UV); break;
-	case 24: outColor = Input.Color * texture(uTextures[24], Input.UV); break;
-	case 25: outColor = Input.Color * texture(uTextures[25], Input.UV); break;
-	case 26: outColor = Input.Color * texture(uTextures[26], Input.UV); break;
-	case 27: outColor = Input.Color * texture(uTextures[27], Input.UV); break;
-	case 28: outColor = Input.Color * texture(uTextures[28], Input.UV); break;
-	case 29: outColor = Input.Color * texture(uTextures[29], Input.UV); break;
-	case 30: outColor = Input.Color * texture(uTextures[30], Input.UV); break;
-	case 31: outColor = Input.Color * texture(uTextures[31], Input.UV); break;
-	}
-}
\ No newline at end of file
+	outColor = Input.Color * SampleTexture(Input.TexID, Input.UV, Input.ArrayLayer);
+}
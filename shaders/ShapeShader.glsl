@@ -0,0 +1,151 @@
+#type vertex
+#version 460 core
+
+// Variants, see BatchMode: INSTANCED reads a shape per instance, PULLING reads
+// the shapes from a storage buffer, neither of them has vertices
+
+#if defined(INSTANCED)
+// Instance Attributes
+layout(location = 0) in vec3  aRow0;    // model transform, first row
+layout(location = 1) in vec3  aRow1;    // model transform, second row
+layout(location = 2) in vec4  aBounds;  // local min in xy, max in zw
+layout(location = 3) in vec4  aColor;
+layout(location = 4) in vec4  aParams;  // meaning depends on the shape type
+layout(location = 5) in float aThickness;
+layout(location = 6) in float aSmoothness;
+layout(location = 7) in float aType;
+#elif defined(PULLING)
+// ShapeInstance, scalars only so std430 lays it out like the C++ struct
+struct Shape
+{
+	float Model[6];   // model transform, row major
+	float Bounds[4];  // local min, local max
+	uint  Color;
+	float Params[4];  // meaning depends on the shape type
+	float Thickness;
+	float Smoothness;
+	float Type;
+};
+
+layout (std430, binding = 0) readonly buffer Shapes
+{
+	Shape uShapes[];
+};
+#else
+layout(location = 0) in vec2  aWorldPosition;
+layout(location = 1) in vec2  aLocalPosition;
+layout(location = 2) in vec4  aColor;
+layout(location = 3) in vec4  aParams;  // meaning depends on the shape type
+layout(location = 4) in float aThickness;
+layout(location = 5) in float aSmoothness;
+layout(location = 6) in float aType;
+#endif
+
+#include "include/Frame.glsl"
+
+struct VertexOutput
+{
+	vec2  LocalPosition;
+	vec4  Color;
+	vec4  Params;
+	float Thickness;
+	float Smoothness;
+	float Type;
+};
+
+layout (location = 0) out VertexOutput Output;
+
+#include "include/Corners.glsl"
+
+void main()
+{
+#if defined(INSTANCED)
+	vec2 local    = mix(aBounds.xy, aBounds.zw, cCorners[gl_VertexID]);
+	vec2 position = vec2(dot(aRow0, vec3(local, 1.0f)), dot(aRow1, vec3(local, 1.0f)));
+
+	Output.LocalPosition = local;
+	Output.Color = aColor;
+	Output.Params = aParams;
+	Output.Thickness = aThickness;
+	Output.Smoothness = aSmoothness;
+	Output.Type = aType;
+#elif defined(PULLING)
+	Shape s = uShapes[gl_VertexID / 6];
+
+	vec2 local    = mix(vec2(s.Bounds[0], s.Bounds[1]),
+	                    vec2(s.Bounds[2], s.Bounds[3]),
+	                    cCorners[gl_VertexID % 6]);
+	vec2 position = vec2(dot(vec3(s.Model[0], s.Model[1], s.Model[2]), vec3(local, 1.0f)),
+	                     dot(vec3(s.Model[3], s.Model[4], s.Model[5]), vec3(local, 1.0f)));
+
+	Output.LocalPosition = local;
+	Output.Color = unpackUnorm4x8(s.Color);
+	Output.Params = vec4(s.Params[0], s.Params[1], s.Params[2], s.Params[3]);
+	Output.Thickness = s.Thickness;
+	Output.Smoothness = s.Smoothness;
+	Output.Type = s.Type;
+#else
+	vec2 position = aWorldPosition;
+
+	Output.LocalPosition = aLocalPosition;
+	Output.Color = aColor;
+	Output.Params = aParams;
+	Output.Thickness = aThickness;
+	Output.Smoothness = aSmoothness;
+	Output.Type = aType;
+#endif
+
+	gl_Position = vec4(uViewProjection * vec3(position, 1.0f), 0.0f, 1.0f);
+}
+
+#type fragment
+#version 460 core
+
+layout(location = 0) out vec4 outColor;
+
+struct VertexOutput
+{
+	vec2  LocalPosition;
+	vec4  Color;
+	vec4  Params;
+	float Thickness;
+	float Smoothness;
+	float Type;
+};
+
+layout (location = 0) in VertexOutput Input;
+
+// pixels the edge fades over at least, see RendererSettings::ShapeEdgeWidth
+layout (constant_id = 0) const float cEdgeWidth = 1.0f;
+
+#include "include/Distance.glsl"
+
+void main()
+{
+	vec2 p = Input.LocalPosition;
+	vec4 k = Input.Params;
+
+	// distance to the edge, positive inside
+	float distance;
+	switch(int(Input.Type))
+	{
+	case 0: distance = -Circle(p, k.x); break;
+	case 1: distance = -Box(p, k.xy, k.z); break;
+	case 2: distance = -Capsule(p, k.x, k.y); break;
+	default: distance = -Triangle(p, k.xy, k.zw); break;
+	}
+
+	// fwidth is how much the distance changes over a pixel
+	float smoothness = max(Input.Smoothness, cEdgeWidth * fwidth(distance));
+	float shape      = smoothstep(0.0f, smoothness, distance);
+
+	// outline of the given thickness, 0 fills the shape
+	if(Input.Thickness > 0.0f)
+		shape *= smoothstep(Input.Thickness + smoothness, Input.Thickness, distance);
+
+	if(shape <= 0.0f)
+		discard;
+
+	outColor = Input.Color;
+	outColor.a *= shape;
+}
@@ -0,0 +1,16 @@
+#if defined(PULLING)
+// Unit quad corner of each of the six vertices, same order as the index buffer of
+// the other modes (0, 1, 2, 2, 3, 0)
+const vec2 cCorners[6] = vec2[6](vec2(0.0f, 0.0f),
+                                 vec2(1.0f, 0.0f),
+                                 vec2(1.0f, 1.0f),
+                                 vec2(1.0f, 1.0f),
+                                 vec2(0.0f, 1.0f),
+                                 vec2(0.0f, 0.0f));
+#else
+// Unit quad corners, indexed by the quad index buffer (0, 1, 2, 2, 3, 0)
+const vec2 cCorners[4] = vec2[4](vec2(0.0f, 0.0f),
+                                 vec2(1.0f, 0.0f),
+                                 vec2(1.0f, 1.0f),
+                                 vec2(0.0f, 1.0f));
+#endif
@@ -0,0 +1,41 @@
+// Signed distances in the local space of the shape, negative inside
+
+float Circle(vec2 p, float r)
+{
+	return length(p) - r;
+}
+
+// half size b, corner radius r
+float Box(vec2 p, vec2 b, float r)
+{
+	vec2 q = abs(p) - b + r;
+	return length(max(q, 0.0f)) + min(max(q.x, q.y), 0.0f) - r;
+}
+
+// segment from (-h, 0) to (h, 0)
+float Capsule(vec2 p, float h, float r)
+{
+	p.x -= clamp(p.x, -h, h);
+	return length(p) - r;
+}
+
+// triangle (0, 0), b, c in any winding
+float Triangle(vec2 p, vec2 b, vec2 c)
+{
+	vec2 e0 = b;
+	vec2 e1 = c - b;
+	vec2 e2 = -c;
+	vec2 v1 = p - b;
+	vec2 v2 = p - c;
+
+	vec2 q0 = p - e0 * clamp(dot(p, e0) / dot(e0, e0), 0.0f, 1.0f);
+	vec2 q1 = v1 - e1 * clamp(dot(v1, e1) / dot(e1, e1), 0.0f, 1.0f);
+	vec2 q2 = v2 - e2 * clamp(dot(v2, e2) / dot(e2, e2), 0.0f, 1.0f);
+
+	float s = sign(e0.x * e2.y - e0.y * e2.x);
+	vec2  d = min(min(vec2(dot(q0, q0), s * (p.x * e0.y - p.y * e0.x)),
+	                  vec2(dot(q1, q1), s * (v1.x * e1.y - v1.y * e1.x))),
+	                  vec2(dot(q2, q2), s * (v2.x * e2.y - v2.y * e2.x)));
+
+	return -sqrt(d.x) * sign(d.y);
+}
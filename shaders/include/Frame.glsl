@@ -0,0 +1,8 @@
+// Shared by every shader, one record per render pass, see FrameUniforms.
+// std140 pads the rows of the view projection to vec4.
+layout(std140, row_major, binding = 0) uniform Frame
+{
+	mat3x2 uViewProjection;
+	vec2   uViewport;  // size of the render target in pixels
+	float  uTime;      // seconds since the renderer was created
+};
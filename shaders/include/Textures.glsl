@@ -0,0 +1,67 @@
+// Texture units [0, TEXTURE_SLOTS) hold 2D textures, the ARRAY_SLOTS units after
+// them array textures. Defined by Renderer when the device has fewer units.
+#ifndef TEXTURE_SLOTS
+	#define TEXTURE_SLOTS 28
+#endif
+#ifndef ARRAY_SLOTS
+	#define ARRAY_SLOTS 4
+#endif
+
+layout(binding = 0) uniform sampler2D uTextures[TEXTURE_SLOTS];
+layout(binding = TEXTURE_SLOTS) uniform sampler2DArray uTextureArrays[ARRAY_SLOTS];
+
+// the cases past the slot count are never taken, they sample the last slot
+#define SAMPLE_2D(i) \
+	case i: return texture(uTextures[min(i, TEXTURE_SLOTS - 1)], uv)
+#define SAMPLE_ARRAY(i) \
+	case i: return texture(uTextureArrays[min(i, ARRAY_SLOTS - 1)], vec3(uv, layer))
+
+// Samplers can not be indexed by a varying, hence the switch
+vec4 SampleTexture(float id, vec2 uv, float layer)
+{
+	int slot = int(id);
+	if(slot >= TEXTURE_SLOTS)
+	{
+		switch(slot - TEXTURE_SLOTS)
+		{
+		SAMPLE_ARRAY(0);
+		SAMPLE_ARRAY(1);
+		SAMPLE_ARRAY(2);
+		SAMPLE_ARRAY(3);
+		}
+		return vec4(1.0f);
+	}
+
+	switch(slot)
+	{
+	SAMPLE_2D(0);
+	SAMPLE_2D(1);
+	SAMPLE_2D(2);
+	SAMPLE_2D(3);
+	SAMPLE_2D(4);
+	SAMPLE_2D(5);
+	SAMPLE_2D(6);
+	SAMPLE_2D(7);
+	SAMPLE_2D(8);
+	SAMPLE_2D(9);
+	SAMPLE_2D(10);
+	SAMPLE_2D(11);
+	SAMPLE_2D(12);
+	SAMPLE_2D(13);
+	SAMPLE_2D(14);
+	SAMPLE_2D(15);
+	SAMPLE_2D(16);
+	SAMPLE_2D(17);
+	SAMPLE_2D(18);
+	SAMPLE_2D(19);
+	SAMPLE_2D(20);
+	SAMPLE_2D(21);
+	SAMPLE_2D(22);
+	SAMPLE_2D(23);
+	SAMPLE_2D(24);
+	SAMPLE_2D(25);
+	SAMPLE_2D(26);
+	SAMPLE_2D(27);
+	}
+	return vec4(1.0f);
+}
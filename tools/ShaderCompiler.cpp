@@ -0,0 +1,92 @@
+#include <Logger.hpp>
+#include <ShaderSource.hpp>
+
+// shader-compiler [--pack] <file.glsl> <output directory> [DEFINE...]
+//
+// Preprocesses a variant of a shader file for glslangValidator, see
+// tools/CMakeLists.txt. Writes <module>.vert and <module>.frag to the output
+// directory, <module> is ShaderSource::GetModuleName. Specialization constants
+// are left in for glSpecializeShader.
+// --pack then puts a ShaderModuleHeader in front of <module>.vert.spirv and
+// <module>.frag.spirv compiled by glslangValidator, as <module>.vert.spv and
+// <module>.frag.spv. ShaderGL rejects modules of another version of the source.
+static bool Write(const Path& path, const void* data, size_t size)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::app);
+	out.write(static_cast<const char*>(data), std::streamsize(size));
+	if(!out)
+	{
+		ERROR("Could not write to file %s", path.generic_string());
+		return false;
+	}
+	return true;
+}
+
+static bool Write(const Path& path, const String& source)
+{
+	fs::remove(path);
+	return Write(path, source.data(), source.size());
+}
+
+static bool Pack(const String& base, const ShaderModuleHeader& header)
+{
+	std::ifstream in(base + ".spirv", std::ios::binary);
+	if(!in)
+	{
+		ERROR("Could not open file %s.spirv", base);
+		return false;
+	}
+
+	String module((std::istreambuf_iterator<char>(in)),
+	              std::istreambuf_iterator<char>());
+
+	Path path = base + ".spv";
+	fs::remove(path);
+	return Write(path, &header, sizeof(header)) &&
+	       Write(path, module.data(), module.size());
+}
+
+int main(int argc, char** argv)
+{
+	Logger::Init();
+
+	bool pack = argc > 1 && String(argv[1]) == "--pack";
+	if(pack)
+	{
+		--argc;
+		++argv;
+	}
+
+	if(argc < 3)
+	{
+		ERROR("Usage: shader-compiler [--pack] <file.glsl> <output directory> "
+		      "[DEFINE...]");
+		return 1;
+	}
+
+	Path        file   = argv[1];
+	Path        output = argv[2];
+	StringArray defines(argv + 3, argv + argc);
+
+	ShaderSource source(file, defines, {}, ShaderTarget::SPIRV);
+	if(source.GetVertex().empty() || source.GetFragment().empty())
+		return 1;
+
+	fs::create_directories(output);
+
+	Path base = output / source.GetModuleName();
+	if(pack)
+	{
+		ShaderModuleHeader header {ShaderModuleMagic, 0, source.GetHash()};
+		if(!Pack(base.string() + ".vert", header) ||
+		   !Pack(base.string() + ".frag", header))
+			return 1;
+		return 0;
+	}
+
+	if(!Write(base.string() + ".vert", source.GetVertex()) ||
+	   !Write(base.string() + ".frag", source.GetFragment()))
+		return 1;
+
+	return 0;
+}